@@ -0,0 +1,74 @@
+/**
+ * \file benchmark-private.hpp
+ * \authors Rachel Lee
+ * \brief Implements the templated parts of the benchmark harness.
+ *
+ * \remark There is no include-guard for this file, because it is
+ *         only #included by benchmark.hpp, inside benchmark.hpp's own
+ *         include guard.
+ */
+
+#include <random>
+
+template <class Body>
+void Benchmark::measure(const char* operation, size_t count, Body body)
+{
+    std::vector<double> nsPerOp;
+    nsPerOp.reserve(count / BATCH + 1);
+    double totalNs = 0;
+    CounterSample before = PerfCounters::thisThread().read();
+
+    for (size_t first = 0; first < count; first += BATCH) {
+        size_t last = first + BATCH < count ? first + BATCH : count;
+        Clock::time_point start = Clock::now();
+        for (size_t i = first; i < last; ++i)
+            body(i);
+        double ns = std::chrono::duration<double, std::nano>(Clock::now()
+                                                              - start).count();
+        totalNs += ns;
+        nsPerOp.push_back(ns / double(last - first));
+    }
+
+    // The samples themselves were reserved up front, so they don't count
+    CounterSample spent = PerfCounters::thisThread().read() - before;
+    record(operation, count, nsPerOp, totalNs, spent);
+}
+
+template <class Body>
+void Benchmark::measureAll(const char* operation, size_t count, Body body)
+{
+    std::vector<double> nsPerOp;
+    nsPerOp.reserve(1);
+    CounterSample before = PerfCounters::thisThread().read();
+
+    Clock::time_point start = Clock::now();
+    body();
+    double ns = std::chrono::duration<double, std::nano>(Clock::now()
+                                                          - start).count();
+    CounterSample spent = PerfCounters::thisThread().read() - before;
+    nsPerOp.push_back(count == 0 ? 0 : ns / double(count));
+    record(operation, count, nsPerOp, ns, spent);
+}
+
+template <class T>
+std::vector<T> sample(const std::vector<T>& values, size_t count,
+                      std::uint64_t seed)
+{
+    std::mt19937_64 random{seed};
+    std::vector<T> picked;
+    picked.reserve(count);
+    for (size_t i = 0; i < count && !values.empty(); ++i)
+        picked.push_back(values[random() % values.size()]);
+    return picked;
+}
+
+template <class T>
+void keep(const T& value)
+{
+#ifdef __GNUC__
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &value;
+#endif
+}
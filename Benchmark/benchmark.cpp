@@ -0,0 +1,238 @@
+/*
+ * \file benchmark.cpp
+ * \authors Rachel Lee
+ * \brief Implemenation of the benchmark harness.
+ */
+
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+using namespace std;
+
+// --------------------------------------
+// Implementation of Benchmark
+// --------------------------------------
+
+// Peak resident set size of this process so far, in KiB
+static long peakRssKb()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+Benchmark::Benchmark(string container, size_t defaultN,
+                     size_t defaultLookups, int argc, char** argv)
+    : container_{std::move(container)}, n_{defaultN},
+      lookups_{defaultLookups}, seed_{42}
+{
+    for (int i = 1; i + 1 < argc; i += 2) {
+        unsigned long long value = strtoull(argv[i + 1], nullptr, 10);
+        if (strcmp(argv[i], "--n") == 0) {
+            n_ = size_t(value);
+        } else if (strcmp(argv[i], "--lookups") == 0) {
+            lookups_ = size_t(value);
+        } else if (strcmp(argv[i], "--seed") == 0) {
+            seed_ = value;
+        } else {
+            cerr << "unknown option " << argv[i] << endl;
+            exit(2);
+        }
+    }
+    if (lookups_ == 0)
+        lookups_ = n_;
+}
+
+size_t Benchmark::n() const
+{
+    return n_;
+}
+
+size_t Benchmark::lookups() const
+{
+    return lookups_;
+}
+
+uint64_t Benchmark::seed() const
+{
+    return seed_;
+}
+
+void Benchmark::run(const string& implementation,
+                    const function<void(Benchmark&)>& workload)
+{
+    string header = "{\"implementation\": \"" + implementation + "\", ";
+
+    // Anything still buffered would be written twice
+    cout.flush();
+    cerr.flush();
+
+    int channel[2];
+    pid_t child = -1;
+    if (pipe(channel) == 0)
+        child = fork();
+    if (child == 0) {
+        close(channel[0]);
+        operations_.clear();
+        resetProbeTotals();
+        workload(*this);
+
+        string json = header + "\"peak_rss_kb\": " + to_string(peakRssKb())
+                      + ", \"operations\": [" + operations_ + "\n  ], "
+                      + "\"probes\": [" + probesJson() + "\n  ]}";
+        for (size_t done = 0; done < json.size(); ) {
+            ssize_t wrote = write(channel[1], json.data() + done,
+                                  json.size() - done);
+            if (wrote <= 0)
+                _exit(1);
+            done += size_t(wrote);
+        }
+        _exit(0);
+    }
+
+    string json;
+    int status = -1;
+    if (child > 0) {
+        close(channel[1]);
+        char buffer[4096];
+        ssize_t got;
+        while ((got = read(channel[0], buffer, sizeof buffer)) > 0)
+            json.append(buffer, size_t(got));
+        close(channel[0]);
+        waitpid(child, &status, 0);
+    }
+
+    if (child < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0)
+        json = header + "\"error\": \"workload did not complete\"}";
+    implementations_.push_back(json);
+}
+
+void Benchmark::record(const char* operation, size_t count,
+                       vector<double>& nsPerOp, double totalNs,
+                       const CounterSample& spent)
+{
+    sort(nsPerOp.begin(), nsPerOp.end());
+    auto percentile = [&nsPerOp](double p) {
+        if (nsPerOp.empty())
+            return 0.0;
+        size_t at = size_t(p * double(nsPerOp.size()));
+        return nsPerOp[at < nsPerOp.size() ? at : nsPerOp.size() - 1];
+    };
+
+    const PerfCounters& counters = PerfCounters::thisThread();
+    auto perOp = [count, &counters](PerfCounters::Counter counter,
+                                    uint64_t total) {
+        if (!counters.available(counter))
+            return string("null");
+        char number[32];
+        snprintf(number, sizeof number, "%.6g",
+                 count == 0 ? 0.0 : double(total) / double(count));
+        return string(number);
+    };
+
+    char json[768];
+    snprintf(json, sizeof json,
+             "%s\n    {\"operation\": \"%s\", \"ops\": %zu, "
+             "\"ops_per_sec\": %.0f, "
+             "\"ns_per_op\": {\"mean\": %.2f, \"p50\": %.2f, \"p90\": %.2f, "
+             "\"p99\": %.2f, \"max\": %.2f}, "
+             "\"allocations_per_op\": %.6g, \"cycles_per_op\": %s, "
+             "\"llc_misses_per_op\": %s, \"branch_misses_per_op\": %s, "
+             "\"peak_rss_kb\": %ld}",
+             operations_.empty() ? "" : ",", operation, count,
+             totalNs > 0 ? double(count) * 1e9 / totalNs : 0.0,
+             count == 0 ? 0.0 : totalNs / double(count), percentile(0.5),
+             percentile(0.9), percentile(0.99),
+             nsPerOp.empty() ? 0.0 : nsPerOp.back(),
+             count == 0 ? 0.0 : double(spent.allocations) / double(count),
+             perOp(PerfCounters::CYCLES, spent.cycles).c_str(),
+             perOp(PerfCounters::LLC_MISSES, spent.llcMisses).c_str(),
+             perOp(PerfCounters::BRANCH_MISSES, spent.branchMisses).c_str(),
+             peakRssKb());
+    operations_ += json;
+}
+
+string Benchmark::probesJson()
+{
+    const PerfCounters& counters = PerfCounters::thisThread();
+    auto total = [&counters](PerfCounters::Counter counter, uint64_t value) {
+        return counters.available(counter) ? to_string(value) : string("null");
+    };
+
+    string json;
+    for (const ProbeTotals& probe : probeTotals()) {
+        json += json.empty() ? "\n    " : ",\n    ";
+        json += "{\"probe\": \"" + probe.name + "\", \"calls\": "
+                + to_string(probe.calls) + ", \"allocations\": "
+                + to_string(probe.counters.allocations) + ", \"cycles\": "
+                + total(PerfCounters::CYCLES, probe.counters.cycles)
+                + ", \"llc_misses\": "
+                + total(PerfCounters::LLC_MISSES, probe.counters.llcMisses)
+                + ", \"branch_misses\": "
+                + total(PerfCounters::BRANCH_MISSES, probe.counters.branchMisses)
+                + "}";
+    }
+    return json;
+}
+
+void Benchmark::print(ostream& out) const
+{
+    out << "{\"container\": \"" << container_ << "\", \"n\": " << n_
+        << ", \"lookups\": " << lookups_ << ", \"seed\": " << seed_
+        << ", \"batch\": " << BATCH << ", \"implementations\": [";
+    for (size_t i = 0; i < implementations_.size(); ++i)
+        out << (i == 0 ? "\n " : ",\n ") << implementations_[i];
+    out << "\n]}" << endl;
+}
+
+// --------------------------------------
+// Workloads
+// --------------------------------------
+
+vector<int> distinctInts(size_t n, uint64_t seed)
+{
+    // i -> i * odd + offset is a bijection mod 2^30, so the values are
+    // distinct and look random without a shuffle
+    mt19937_64 random{seed};
+    uint32_t multiplier = uint32_t(random()) | 1;
+    uint32_t offset = uint32_t(random());
+    const uint32_t MASK = (uint32_t(1) << 30) - 1;
+
+    vector<int> values;
+    values.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        uint32_t k = (uint32_t(i) * multiplier + offset) & MASK;
+        values.push_back(int(k) * 2 - (1 << 30));
+    }
+    return values;
+}
+
+vector<string> distinctStrings(size_t n, char first, uint64_t seed)
+{
+    // A distinct 64-bit number in hex makes each string unique; the random
+    // tail varies the length
+    mt19937_64 random{seed};
+    uint64_t multiplier = random() | 1;
+    uint64_t offset = random();
+
+    vector<string> values;
+    values.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        char hex[17];
+        snprintf(hex, sizeof hex, "%016llx",
+                 (unsigned long long)(uint64_t(i) * multiplier + offset));
+        string value = first + string(hex);
+        for (size_t tail = random() % 8; tail > 0; --tail)
+            value += char('a' + random() % 26);
+        values.push_back(std::move(value));
+    }
+    return values;
+}
@@ -0,0 +1,135 @@
+/**
+ * \file benchmark.hpp
+ * \authors Rachel Lee
+ * \brief A small harness for timing container operations and reporting
+ *        them as JSON.
+ */
+
+#ifndef BENCHMARK_HPP_INCLUDED
+#define BENCHMARK_HPP_INCLUDED 1
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "../Instrumentation/probes.hpp"
+
+/**
+ * \class Benchmark
+ *
+ * \brief Runs the same workload against several implementations of a
+ *        container and prints what it measured as one JSON document.
+ *
+ * \details Each implementation runs in a child process of its own, so the
+ *          peak RSS reported for it isn't inflated by the ones before it.
+ *          Every operation is timed in batches of BATCH calls; the ns/op
+ *          percentiles are over those batches, since a clock read costs
+ *          about as much as a lookup. Each operation also reports the
+ *          cycles, LLC misses and branch misses it took per call, as null
+ *          if the counter is unavailable; with DATASTRUCTURES_PROBES, each
+ *          implementation adds the totals of the probes inside it.
+ *
+ *          Options: --n <values>, --lookups <count> (both defaulted by the
+ *          caller; no lookup default means n lookups) and --seed <seed>
+ *          (default 42).
+ */
+class Benchmark {
+public:
+    /// Calls timed together to give one ns/op sample
+    static constexpr size_t BATCH = 64;
+
+    /**
+     * \brief Reads the options from the command line.
+     */
+    Benchmark(std::string container, size_t defaultN, size_t defaultLookups,
+              int argc, char** argv);
+
+    size_t n() const;          ///< Number of values to insert
+    size_t lookups() const;    ///< Number of lookups of each kind
+    std::uint64_t seed() const; ///< Seed for every workload
+
+    /**
+     * \brief Runs workload in a child process and records its results
+     *        under implementation.
+     *
+     * \details workload calls measure() once per operation.
+     */
+    void run(const std::string& implementation,
+             const std::function<void(Benchmark&)>& workload);
+
+    /**
+     * \brief Times body(i) for i in [0, count) and records it as operation.
+     */
+    template <class Body>
+    void measure(const char* operation, size_t count, Body body);
+
+    /**
+     * \brief Times body(), which performs count operations in one go (such
+     *        as destroying a container of count values), and records it as
+     *        operation.
+     */
+    template <class Body>
+    void measureAll(const char* operation, size_t count, Body body);
+
+    /**
+     * \brief Prints everything run() has recorded.
+     */
+    void print(std::ostream& out) const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    // Appends one operation's results to the current implementation's JSON
+    void record(const char* operation, size_t count,
+                std::vector<double>& nsPerOp, double totalNs,
+                const CounterSample& spent);
+
+    // JSON for the totals of the probes that ran in this process
+    static std::string probesJson();
+
+    std::string container_;
+    size_t n_;
+    size_t lookups_;
+    std::uint64_t seed_;
+
+    // JSON for the operations of the implementation being run
+    std::string operations_;
+
+    // JSON for each implementation that has been run
+    std::vector<std::string> implementations_;
+};
+
+/**
+ * \brief Returns n distinct ints, shuffled, that are all even; odd values
+ *        are therefore guaranteed misses.
+ */
+std::vector<int> distinctInts(size_t n, std::uint64_t seed);
+
+/**
+ * \brief Returns n distinct strings of 17 to 24 characters, shuffled, that
+ *        all start with first; strings made with a different first
+ *        character are therefore guaranteed misses.
+ */
+std::vector<std::string> distinctStrings(size_t n, char first,
+                                         std::uint64_t seed);
+
+/**
+ * \brief Returns count values picked at random from values.
+ */
+template <class T>
+std::vector<T> sample(const std::vector<T>& values, size_t count,
+                      std::uint64_t seed);
+
+/**
+ * \brief Keeps the compiler from optimizing away value.
+ */
+template <class T>
+void keep(const T& value);
+
+#include "benchmark-private.hpp"
+
+#endif // BENCHMARK_HPP_INCLUDED
@@ -0,0 +1,82 @@
+/*
+ * \file btreesetbench.cpp
+ * \authors Rachel Lee
+ * \brief Benchmarks BTreeSet against TreeSet, with int and string keys.
+ *
+ * \details Every pairing runs twice: with --n keys, which by default is
+ *          too many for the cache, and with IN_CACHE keys, which fit.
+ */
+
+#include "../Tree/BTree/btreeset.hpp"
+#include "../Tree/RandomizedBST/treeset.hpp"
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/// Keys in the runs meant to stay in cache
+static const size_t IN_CACHE = 10000;
+
+// The values are all even, so odd ones miss
+static void keys(const Benchmark& bench, size_t n, vector<int>& values,
+                 vector<int>& misses)
+{
+    values = distinctInts(n, bench.seed());
+    misses = sample(values, bench.lookups(), bench.seed() + 2);
+    for (int& miss : misses)
+        miss += 1;
+}
+
+static void keys(const Benchmark& bench, size_t n, vector<string>& values,
+                 vector<string>& misses)
+{
+    values = distinctStrings(n, 'k', bench.seed());
+    misses = distinctStrings(bench.lookups(), 'm', bench.seed() + 2);
+}
+
+template <class Set, class T>
+static void workload(Benchmark& bench, size_t n)
+{
+    vector<T> values;
+    vector<T> misses;
+    keys(bench, n, values, misses);
+    vector<T> hits = sample(values, bench.lookups(), bench.seed() + 1);
+
+    Set* set = new Set;
+    bench.measure("insert", values.size(),
+                  [&](size_t i) { set->insert(values[i]); });
+
+    size_t found = 0;
+    bench.measure("lookup_hit", hits.size(),
+                  [&](size_t i) { found += set->exists(hits[i]); });
+    bench.measure("lookup_miss", misses.size(),
+                  [&](size_t i) { found += set->exists(misses[i]); });
+    keep(found);
+
+    bench.measureAll("destroy", values.size(), [&] { delete set; });
+}
+
+// Runs Set with --n keys and with IN_CACHE keys
+template <class Set, class T>
+static void runBoth(Benchmark& bench, const string& name)
+{
+    size_t small = min(bench.n(), IN_CACHE);
+    bench.run(name + ", " + to_string(bench.n()) + " keys",
+              [](Benchmark& b) { workload<Set, T>(b, b.n()); });
+    bench.run(name + ", " + to_string(small) + " keys",
+              [small](Benchmark& b) { workload<Set, T>(b, small); });
+}
+
+int main(int argc, char** argv)
+{
+    Benchmark bench{"BTreeSet", 1000000, 200000, argc, argv};
+    runBoth<BTreeSet<int>, int>(bench, "BTreeSet<int>");
+    runBoth<TreeSet<int>, int>(bench, "TreeSet<int>");
+    runBoth<BTreeSet<string>, string>(bench, "BTreeSet<std::string>");
+    runBoth<TreeSet<string>, string>(bench, "TreeSet<std::string>");
+    bench.print(cout);
+    return 0;
+}
@@ -0,0 +1,136 @@
+/*
+ * \file concurrentintqueuebench.cpp
+ * \authors Rachel Lee
+ * \brief Benchmarks ConcurrentIntQueue against an IntList behind a mutex,
+ *        with 1 to 32 producers and as many consumers.
+ *
+ * \details Here --n is the number of values passed through the queue, split
+ *          evenly over the producers; --lookups is unused. The "transfer"
+ *          time runs from starting the threads until the consumers have
+ *          popped every value.
+ */
+
+#include "../LinkedList/concurrentintqueue.hpp"
+#include "../LinkedList/intlist.hpp"
+#include "benchmark.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/// Most threads tried on each side; the counts double from 1
+static const size_t MAX_THREADS = 32;
+
+/// Values taken at once by the batched consumers
+static const size_t BATCH_POP = 64;
+
+/**
+ * \class LockedIntList
+ *
+ * \brief An IntList used as a work queue with every call serialized by a
+ *        mutex, as services use one today.
+ */
+class LockedIntList {
+public:
+    void push_back(int pushee)
+    {
+        lock_guard<mutex> lock{mutex_};
+        list_.push_back(pushee);
+    }
+
+    bool try_pop_front(int& popped)
+    {
+        lock_guard<mutex> lock{mutex_};
+        if (list_.empty())
+            return false;
+        popped = list_.pop_front();
+        return true;
+    }
+
+    size_t try_pop_many(int* popped, size_t max)
+    {
+        lock_guard<mutex> lock{mutex_};
+        size_t count = 0;
+        for (; count < max && !list_.empty(); ++count)
+            popped[count] = list_.pop_front();
+        return count;
+    }
+
+private:
+    mutex mutex_;
+    IntList list_;
+};
+
+// Pops one value at a time, or up to BATCH_POP at a time if batched
+template <class Queue>
+static size_t pop(Queue& queue, int* popped, bool batched)
+{
+    if (batched)
+        return queue.try_pop_many(popped, BATCH_POP);
+    return queue.try_pop_front(*popped) ? 1 : 0;
+}
+
+template <class Queue>
+static void workload(Benchmark& bench, size_t threads, bool batched)
+{
+    size_t each = bench.n() / threads;
+    size_t total = each * threads;
+    Queue queue;
+
+    atomic<size_t> popped{0};
+    atomic<long long> sum{0};
+    bench.measureAll("transfer", total, [&] {
+        vector<thread> workers;
+        for (size_t p = 0; p < threads; ++p) {
+            workers.emplace_back([&, p] {
+                for (size_t i = 0; i < each; ++i)
+                    queue.push_back(int(p * each + i));
+            });
+        }
+        for (size_t c = 0; c < threads; ++c) {
+            workers.emplace_back([&] {
+                int values[BATCH_POP];
+                long long mine = 0;
+                while (popped.load(memory_order_relaxed) < total) {
+                    size_t got = pop(queue, values, batched);
+                    if (got == 0) {
+                        this_thread::yield();
+                        continue;
+                    }
+                    for (size_t i = 0; i < got; ++i)
+                        mine += values[i];
+                    popped += got;
+                }
+                sum += mine;
+            });
+        }
+        for (thread& worker : workers)
+            worker.join();
+    });
+    keep(sum.load());
+}
+
+int main(int argc, char** argv)
+{
+    Benchmark bench{"ConcurrentIntQueue", 1000000, 0, argc, argv};
+    for (size_t threads = 1; threads <= MAX_THREADS; threads *= 2) {
+        string suffix = ", " + to_string(threads) + " producers + "
+                        + to_string(threads) + " consumers";
+        bench.run("ConcurrentIntQueue" + suffix, [threads](Benchmark& b) {
+            workload<ConcurrentIntQueue>(b, threads, false);
+        });
+        bench.run("ConcurrentIntQueue, try_pop_many" + suffix,
+                  [threads](Benchmark& b) {
+                      workload<ConcurrentIntQueue>(b, threads, true);
+                  });
+        bench.run("IntList + mutex" + suffix, [threads](Benchmark& b) {
+            workload<LockedIntList>(b, threads, false);
+        });
+    }
+    bench.print(cout);
+    return 0;
+}
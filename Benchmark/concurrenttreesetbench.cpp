@@ -0,0 +1,109 @@
+/*
+ * \file concurrenttreesetbench.cpp
+ * \authors Rachel Lee
+ * \brief Benchmarks reads from ConcurrentTreeSet against a TreeSet behind
+ *        a mutex, with 1 to 64 readers and one writer.
+ *
+ * \details Here --n is the number of values loaded before the readers start
+ *          and --lookups is the number of lookups each reader makes. The
+ *          writer keeps inserting new values until every reader is done.
+ *          The "lookup" time is wall-clock time over all readers' lookups,
+ *          so ops_per_sec is the combined read throughput.
+ */
+
+#include "../Tree/RandomizedBST/concurrenttreeset.hpp"
+#include "../Tree/RandomizedBST/treeset.hpp"
+#include "benchmark.hpp"
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+/// Most readers tried; the counts double from 1
+static const size_t MAX_READERS = 64;
+
+/**
+ * \class LockedTreeSet
+ *
+ * \brief A TreeSet with every call serialized by a mutex, as services use
+ *        one today.
+ */
+class LockedTreeSet {
+public:
+    void insert(int item)
+    {
+        lock_guard<mutex> lock{mutex_};
+        set_.insert(item);
+    }
+
+    bool exists(int item) const
+    {
+        lock_guard<mutex> lock{mutex_};
+        return set_.exists(item);
+    }
+
+private:
+    mutable mutex mutex_;
+    TreeSet<int> set_;
+};
+
+template <class Set>
+static void workload(Benchmark& bench, size_t readers)
+{
+    // The first n values are loaded up front; the writer works through the
+    // rest
+    vector<int> values = distinctInts(2 * bench.n(), bench.seed());
+    vector<int> loaded(values.begin(), values.begin() + bench.n());
+    vector<vector<int>> hits;
+    for (size_t r = 0; r < readers; ++r)
+        hits.push_back(sample(loaded, bench.lookups(), bench.seed() + 1 + r));
+
+    Set set;
+    for (int value : loaded)
+        set.insert(value);
+
+    atomic<bool> done{false};
+    thread writer{[&] {
+        for (size_t i = bench.n(); i < values.size() && !done; ++i)
+            set.insert(values[i]);
+    }};
+
+    atomic<size_t> found{0};
+    bench.measureAll("lookup", readers * bench.lookups(), [&] {
+        vector<thread> threads;
+        for (size_t r = 0; r < readers; ++r) {
+            threads.emplace_back([&, r] {
+                size_t mine = 0;
+                for (int value : hits[r])
+                    mine += set.exists(value);
+                found += mine;
+            });
+        }
+        for (thread& reader : threads)
+            reader.join();
+    });
+
+    done = true;
+    writer.join();
+    keep(found.load());
+}
+
+int main(int argc, char** argv)
+{
+    Benchmark bench{"ConcurrentTreeSet", 100000, 100000, argc, argv};
+    for (size_t readers = 1; readers <= MAX_READERS; readers *= 2) {
+        string suffix = ", " + to_string(readers) + " readers + 1 writer";
+        bench.run("ConcurrentTreeSet<int>" + suffix, [readers](Benchmark& b) {
+            workload<ConcurrentTreeSet<int>>(b, readers);
+        });
+        bench.run("TreeSet<int> + mutex" + suffix, [readers](Benchmark& b) {
+            workload<LockedTreeSet>(b, readers);
+        });
+    }
+    bench.print(cout);
+    return 0;
+}
@@ -0,0 +1,56 @@
+/*
+ * \file countingnew.cpp
+ * \authors Rachel Lee
+ * \brief A global operator new replacement that counts allocations for
+ *        PerfCounters::allocations().
+ *
+ * \details Linked into the benchmarks only, so programs that just use the
+ *          library keep the standard operator new (and a sanitizer's).
+ */
+
+#include "../Instrumentation/probes.hpp"
+
+#include <cstdlib>
+#include <new>
+
+using namespace std;
+
+void* operator new(size_t size)
+{
+    PerfCounters::countAllocation();
+    if (void* memory = malloc(size == 0 ? 1 : size))
+        return memory;
+    throw bad_alloc{};
+}
+
+void* operator new(size_t size, align_val_t alignment)
+{
+    PerfCounters::countAllocation();
+    void* memory;
+    size_t align = size_t(alignment) < sizeof(void*) ? sizeof(void*)
+                                                     : size_t(alignment);
+    if (posix_memalign(&memory, align, size == 0 ? 1 : size) == 0)
+        return memory;
+    throw bad_alloc{};
+}
+
+// The array and nothrow forms all come through the two above
+void operator delete(void* memory) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void* memory, size_t) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void* memory, align_val_t) noexcept
+{
+    free(memory);
+}
+
+void operator delete(void* memory, size_t, align_val_t) noexcept
+{
+    free(memory);
+}
@@ -0,0 +1,75 @@
+/*
+ * \file hashsetbench.cpp
+ * \authors Rachel Lee
+ * \brief Benchmarks HashSet<std::string> against std::unordered_set.
+ */
+
+// myhash() has to be declared before HashSet's definitions use it
+#include "../HashTable/stringhash.hpp"
+#include "../HashTable/hashset.hpp"
+#include "benchmark.hpp"
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+static bool contains(const HashSet<string>& set, const string& value)
+{
+    return set.exists(value);
+}
+
+static bool contains(const unordered_set<string>& set, const string& value)
+{
+    return set.count(value) != 0;
+}
+
+// HashSet has no iterators
+static void iterate(Benchmark&, const HashSet<string>&)
+{
+}
+
+static void iterate(Benchmark& bench, const unordered_set<string>& set)
+{
+    auto here = set.begin();
+    size_t length = 0;
+    bench.measure("iteration", set.size(), [&](size_t) {
+        length += here->size();
+        ++here;
+    });
+    keep(length);
+}
+
+template <class Set>
+static void workload(Benchmark& bench)
+{
+    vector<string> values = distinctStrings(bench.n(), 'k', bench.seed());
+    vector<string> hits = sample(values, bench.lookups(), bench.seed() + 1);
+    vector<string> misses =
+        distinctStrings(bench.lookups(), 'm', bench.seed() + 2);
+
+    Set* set = new Set;
+    bench.measure("insert", values.size(),
+                  [&](size_t i) { set->insert(values[i]); });
+
+    size_t found = 0;
+    bench.measure("lookup_hit", hits.size(),
+                  [&](size_t i) { found += contains(*set, hits[i]); });
+    bench.measure("lookup_miss", misses.size(),
+                  [&](size_t i) { found += contains(*set, misses[i]); });
+    keep(found);
+
+    iterate(bench, *set);
+    bench.measureAll("destroy", values.size(), [&] { delete set; });
+}
+
+int main(int argc, char** argv)
+{
+    Benchmark bench{"HashSet", 1000000, 0, argc, argv};
+    bench.run("HashSet<std::string>", workload<HashSet<string>>);
+    bench.run("std::unordered_set<std::string>",
+              workload<unordered_set<string>>);
+    bench.print(cout);
+    return 0;
+}
@@ -0,0 +1,87 @@
+/*
+ * \file intlistbench.cpp
+ * \authors Rachel Lee
+ * \brief Benchmarks IntList and UnrolledIntList against std::forward_list.
+ */
+
+#include "../LinkedList/intlist.hpp"
+#include "../LinkedList/unrolledintlist.hpp"
+#include "benchmark.hpp"
+
+#include <algorithm>
+#include <forward_list>
+#include <vector>
+
+using namespace std;
+
+// Lists are searched from the front, so lookups are O(n) and the default
+// number of them is kept small
+static const size_t LIST_LOOKUPS = 200;
+
+// Appends values to list, timing each push
+template <class List>
+static void insert(Benchmark& bench, List& list, const vector<int>& values)
+{
+    bench.measure("insert", values.size(),
+                  [&](size_t i) { list.push_back(values[i]); });
+}
+
+static void insert(Benchmark& bench, forward_list<int>& list,
+                   const vector<int>& values)
+{
+    auto back = list.before_begin();
+    bench.measure("insert", values.size(),
+                  [&](size_t i) { back = list.insert_after(back, values[i]); });
+}
+
+template <class List>
+static bool contains(const List& list, int value)
+{
+    return list.find(value) != list.end();
+}
+
+static bool contains(const forward_list<int>& list, int value)
+{
+    return find(list.begin(), list.end(), value) != list.end();
+}
+
+template <class List>
+static void workload(Benchmark& bench)
+{
+    // The values are all even, so odd ones miss
+    vector<int> values = distinctInts(bench.n(), bench.seed());
+    vector<int> hits = sample(values, bench.lookups(), bench.seed() + 1);
+    vector<int> misses = sample(values, bench.lookups(), bench.seed() + 2);
+    for (int& miss : misses)
+        miss += 1;
+
+    List* list = new List;
+    insert(bench, *list, values);
+
+    size_t found = 0;
+    bench.measure("lookup_hit", hits.size(),
+                  [&](size_t i) { found += contains(*list, hits[i]); });
+    bench.measure("lookup_miss", misses.size(),
+                  [&](size_t i) { found += contains(*list, misses[i]); });
+    keep(found);
+
+    auto here = list->begin();
+    long long sum = 0;
+    bench.measure("iteration", values.size(), [&](size_t) {
+        sum += *here;
+        ++here;
+    });
+    keep(sum);
+
+    bench.measureAll("destroy", values.size(), [&] { delete list; });
+}
+
+int main(int argc, char** argv)
+{
+    Benchmark bench{"IntList", 1000000, LIST_LOOKUPS, argc, argv};
+    bench.run("IntList", workload<IntList>);
+    bench.run("UnrolledIntList", workload<UnrolledIntList>);
+    bench.run("std::forward_list<int>", workload<forward_list<int>>);
+    bench.print(cout);
+    return 0;
+}
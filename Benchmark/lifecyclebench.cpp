@@ -0,0 +1,196 @@
+/*
+ * \file lifecyclebench.cpp
+ * \authors Rachel Lee
+ * \brief Benchmarks request-scoped containers (build, query, discard) on
+ *        the global heap against a RequestArena.
+ *
+ * \details Here --n is the number of values in each request's container and
+ *          --lookups is the number of requests. Each request inserts its
+ *          values, looks every one of them up along with as many misses
+ *          (sums them, for lists), and destroys the container.
+ */
+
+// myhash() has to be declared before HashSet's definitions use it
+#include "../HashTable/stringhash.hpp"
+#include "../HashTable/hashset.hpp"
+#include "../LinkedList/intlist.hpp"
+#include "../Memory/fixedblockresource.hpp"
+#include "../Memory/requestarena.hpp"
+#include "../Tree/RandomizedBST/treeset.hpp"
+#include "benchmark.hpp"
+
+#include <cstdio>
+#include <memory_resource>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+template <class T>
+using ArenaAllocator = pmr::polymorphic_allocator<T>;
+
+/// Different requests cycled through, so each isn't a rerun of the last
+static const size_t DISTINCT_REQUESTS = 16;
+
+/**
+ * \brief The values each request inserts and the ones it should miss.
+ */
+template <class T>
+struct Request {
+    vector<T> values;
+    vector<T> misses;
+};
+
+// Keys short enough for std::string's small buffer, so the only
+// allocations are the containers' own
+static vector<Request<string>> stringRequests(const Benchmark& bench)
+{
+    vector<Request<string>> requests(DISTINCT_REQUESTS);
+    for (size_t r = 0; r < DISTINCT_REQUESTS; ++r) {
+        for (size_t i = 0; i < bench.n(); ++i) {
+            char key[16];
+            uint32_t mixed = uint32_t(i * 2654435761u + r * 40503u
+                                      + bench.seed());
+            snprintf(key, sizeof key, "k%08x", mixed);
+            requests[r].values.push_back(key);
+            key[0] = 'm';
+            requests[r].misses.push_back(key);
+        }
+    }
+    return requests;
+}
+
+static vector<Request<int>> intRequests(const Benchmark& bench)
+{
+    vector<Request<int>> requests(DISTINCT_REQUESTS);
+    for (size_t r = 0; r < DISTINCT_REQUESTS; ++r) {
+        requests[r].values = distinctInts(bench.n(), bench.seed() + r);
+        // The values are all even, so odd ones miss
+        for (int value : requests[r].values)
+            requests[r].misses.push_back(value + 1);
+    }
+    return requests;
+}
+
+// Builds and queries a set; the caller's scope destroys it
+template <class Set, class T>
+static size_t serveSet(Set& set, const Request<T>& request)
+{
+    for (const T& value : request.values)
+        set.insert(value);
+    size_t found = 0;
+    for (const T& value : request.values)
+        found += set.exists(value);
+    for (const T& value : request.misses)
+        found += set.exists(value);
+    return found;
+}
+
+template <class List>
+static long long serveList(List& list, const Request<int>& request)
+{
+    for (int value : request.values)
+        list.push_back(value);
+    return list.sum();
+}
+
+int main(int argc, char** argv)
+{
+    Benchmark bench{"request lifecycle", 1000, 20000, argc, argv};
+    using ArenaHashSet = HashSet<string, ArenaAllocator<string>>;
+
+    bench.run("HashSet, global heap", [](Benchmark& b) {
+        vector<Request<string>> requests = stringRequests(b);
+        size_t found = 0;
+        b.measure("request", b.lookups(), [&](size_t i) {
+            HashSet<string> set;
+            found += serveSet(set, requests[i % DISTINCT_REQUESTS]);
+        });
+        keep(found);
+    });
+    bench.run("HashSet, RequestArena", [](Benchmark& b) {
+        vector<Request<string>> requests = stringRequests(b);
+        RequestArena arena;
+        size_t found = 0;
+        b.measure("request", b.lookups(), [&](size_t i) {
+            {
+                ArenaHashSet set{&arena};
+                found += serveSet(set, requests[i % DISTINCT_REQUESTS]);
+            }
+            arena.reset();
+        });
+        keep(found);
+    });
+    bench.run("HashSet, RequestArena + FixedBlockResource", [](Benchmark& b) {
+        vector<Request<string>> requests = stringRequests(b);
+        RequestArena arena;
+        size_t found = 0;
+        b.measure("request", b.lookups(), [&](size_t i) {
+            {
+                FixedBlockResource nodes{ArenaHashSet::NODE_SIZE, &arena};
+                ArenaHashSet set{&nodes};
+                found += serveSet(set, requests[i % DISTINCT_REQUESTS]);
+            }
+            arena.reset();
+        });
+        keep(found);
+    });
+
+    bench.run("TreeSet, global heap", [](Benchmark& b) {
+        vector<Request<int>> requests = intRequests(b);
+        size_t found = 0;
+        b.measure("request", b.lookups(), [&](size_t i) {
+            TreeSet<int> set;
+            found += serveSet(set, requests[i % DISTINCT_REQUESTS]);
+        });
+        keep(found);
+    });
+    bench.run("TreeSet, RequestArena", [](Benchmark& b) {
+        vector<Request<int>> requests = intRequests(b);
+        RequestArena arena;
+        size_t found = 0;
+        b.measure("request", b.lookups(), [&](size_t i) {
+            {
+                TreeSet<int, uint32_t, ArenaAllocator<int>> set{&arena};
+                found += serveSet(set, requests[i % DISTINCT_REQUESTS]);
+            }
+            arena.reset();
+        });
+        keep(found);
+    });
+
+    bench.run("IntList, global heap", [](Benchmark& b) {
+        vector<Request<int>> requests = intRequests(b);
+        long long sum = 0;
+        b.measure("request", b.lookups(), [&](size_t i) {
+            IntList list;
+            sum += serveList(list, requests[i % DISTINCT_REQUESTS]);
+        });
+        keep(sum);
+    });
+    bench.run("IntList, THREAD_POOL", [](Benchmark& b) {
+        vector<Request<int>> requests = intRequests(b);
+        long long sum = 0;
+        b.measure("request", b.lookups(), [&](size_t i) {
+            IntList list{IntList::Allocation::THREAD_POOL};
+            sum += serveList(list, requests[i % DISTINCT_REQUESTS]);
+        });
+        keep(sum);
+    });
+    bench.run("IntList, RequestArena", [](Benchmark& b) {
+        vector<Request<int>> requests = intRequests(b);
+        RequestArena arena;
+        long long sum = 0;
+        b.measure("request", b.lookups(), [&](size_t i) {
+            {
+                List<int, ArenaAllocator<int>> list{&arena};
+                sum += serveList(list, requests[i % DISTINCT_REQUESTS]);
+            }
+            arena.reset();
+        });
+        keep(sum);
+    });
+
+    bench.print(cout);
+    return 0;
+}
@@ -0,0 +1,125 @@
+/*
+ * \file smallsetbench.cpp
+ * \authors Rachel Lee
+ * \brief Benchmarks many tiny sets, with and without inline storage.
+ *
+ * \details Here --n is the number of values in each set and --lookups is
+ *          the number of sets. All the sets are kept alive at once, so the
+ *          peak RSS shows what each one costs; "build" times filling them
+ *          and "exists" times looking up every value plus as many misses.
+ *          The hash sets hold strings, since HashSet only hashes those.
+ */
+
+// myhash() has to be declared before HashSet's definitions use it
+#include "../HashTable/stringhash.hpp"
+#include "../HashTable/hashset.hpp"
+#include "../Tree/RandomizedBST/treeset.hpp"
+#include "benchmark.hpp"
+
+#include <memory>
+#include <set>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+using namespace std;
+
+/// How many inline items the small variants keep
+static const size_t INLINE = 8;
+
+/// Different value sets cycled through
+static const size_t DISTINCT_SETS = 64;
+
+/**
+ * \brief The values one set holds and the ones it should miss.
+ */
+template <class T>
+struct Values {
+    vector<T> hits;
+    vector<T> misses;
+};
+
+// The second argument only picks the overload
+static vector<Values<int>> valuesFor(const Benchmark& bench, int)
+{
+    vector<Values<int>> values(DISTINCT_SETS);
+    for (size_t s = 0; s < DISTINCT_SETS; ++s) {
+        values[s].hits = distinctInts(bench.n(), bench.seed() + s);
+        // The values are all even, so odd ones miss
+        for (int value : values[s].hits)
+            values[s].misses.push_back(value + 1);
+    }
+    return values;
+}
+
+static vector<Values<string>> valuesFor(const Benchmark& bench, const string&)
+{
+    vector<Values<string>> values(DISTINCT_SETS);
+    for (size_t s = 0; s < DISTINCT_SETS; ++s) {
+        values[s].hits = distinctStrings(bench.n(), 'k', bench.seed() + s);
+        values[s].misses = distinctStrings(bench.n(), 'm', bench.seed() + s);
+    }
+    return values;
+}
+
+template <class Set>
+static bool contains(const Set& set, const typename Set::value_type& value)
+{
+    return set.count(value) != 0;
+}
+
+template <class T, class Allocator, size_t N>
+static bool contains(const HashSet<T, Allocator, N>& set, const T& value)
+{
+    return set.exists(value);
+}
+
+template <class T, class Index, class Allocator, size_t N>
+static bool contains(const TreeSet<T, Index, Allocator, N>& set,
+                     const T& value)
+{
+    return set.exists(value);
+}
+
+template <class Set, class T>
+static void workload(Benchmark& bench)
+{
+    vector<Values<T>> values = valuesFor(bench, T{});
+
+    // Held through unique_ptr so the sets' own footprint is on the heap too
+    vector<unique_ptr<Set>> sets;
+    sets.reserve(bench.lookups());
+    bench.measure("build", bench.lookups(), [&](size_t i) {
+        sets.emplace_back(new Set);
+        for (const T& value : values[i % DISTINCT_SETS].hits)
+            sets.back()->insert(value);
+    });
+
+    size_t found = 0;
+    bench.measure("exists", bench.lookups(), [&](size_t i) {
+        const Values<T>& these = values[i % DISTINCT_SETS];
+        for (const T& value : these.hits)
+            found += contains(*sets[i], value);
+        for (const T& value : these.misses)
+            found += contains(*sets[i], value);
+    });
+    keep(found);
+}
+
+int main(int argc, char** argv)
+{
+    Benchmark bench{"small sets", 4, 1000000, argc, argv};
+
+    bench.run("HashSet<std::string>", workload<HashSet<string>, string>);
+    bench.run("SmallHashSet<std::string, 8>",
+              workload<SmallHashSet<string, INLINE>, string>);
+    bench.run("std::unordered_set<std::string>",
+              workload<unordered_set<string>, string>);
+    bench.run("TreeSet<int>", workload<TreeSet<int>, int>);
+    bench.run("SmallTreeSet<int, 8>",
+              workload<SmallTreeSet<int, INLINE>, int>);
+    bench.run("std::set<int>", workload<set<int>, int>);
+
+    bench.print(cout);
+    return 0;
+}
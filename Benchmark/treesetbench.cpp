@@ -0,0 +1,99 @@
+/*
+ * \file treesetbench.cpp
+ * \authors Rachel Lee
+ * \brief Benchmarks TreeSet<int>, and its compact() snapshot, against
+ *        std::set.
+ */
+
+#include "../Tree/RandomizedBST/treeset.hpp"
+#include "benchmark.hpp"
+
+#include <memory>
+#include <set>
+#include <vector>
+
+using namespace std;
+
+static bool contains(const TreeSet<int>& set, int value)
+{
+    return set.exists(value);
+}
+
+static bool contains(const set<int>& set, int value)
+{
+    return set.count(value) != 0;
+}
+
+// TreeSet has no iterators
+static void iterate(Benchmark&, const TreeSet<int>&)
+{
+}
+
+static void iterate(Benchmark& bench, const set<int>& set)
+{
+    auto here = set.begin();
+    long long sum = 0;
+    bench.measure("iteration", set.size(), [&](size_t) {
+        sum += *here;
+        ++here;
+    });
+    keep(sum);
+}
+
+// Only TreeSet has a read-only snapshot; its lookups use the same keys as
+// the live tree's
+static void snapshot(Benchmark& bench, const TreeSet<int>& set,
+                     const vector<int>& hits, const vector<int>& misses)
+{
+    unique_ptr<TreeSnapshot<int>> snapshot;
+    bench.measureAll("compact", set.size(), [&] {
+        snapshot.reset(new TreeSnapshot<int>{set.compact()});
+    });
+
+    size_t found = 0;
+    bench.measure("snapshot_lookup_hit", hits.size(),
+                  [&](size_t i) { found += snapshot->exists(hits[i]); });
+    bench.measure("snapshot_lookup_miss", misses.size(),
+                  [&](size_t i) { found += snapshot->exists(misses[i]); });
+    keep(found);
+}
+
+static void snapshot(Benchmark&, const set<int>&, const vector<int>&,
+                     const vector<int>&)
+{
+}
+
+template <class Set>
+static void workload(Benchmark& bench)
+{
+    // The values are all even, so odd ones miss
+    vector<int> values = distinctInts(bench.n(), bench.seed());
+    vector<int> hits = sample(values, bench.lookups(), bench.seed() + 1);
+    vector<int> misses = sample(values, bench.lookups(), bench.seed() + 2);
+    for (int& miss : misses)
+        miss += 1;
+
+    Set* set = new Set;
+    bench.measure("insert", values.size(),
+                  [&](size_t i) { set->insert(values[i]); });
+
+    size_t found = 0;
+    bench.measure("lookup_hit", hits.size(),
+                  [&](size_t i) { found += contains(*set, hits[i]); });
+    bench.measure("lookup_miss", misses.size(),
+                  [&](size_t i) { found += contains(*set, misses[i]); });
+    keep(found);
+
+    snapshot(bench, *set, hits, misses);
+    iterate(bench, *set);
+    bench.measureAll("destroy", values.size(), [&] { delete set; });
+}
+
+int main(int argc, char** argv)
+{
+    Benchmark bench{"TreeSet", 1000000, 0, argc, argv};
+    bench.run("TreeSet<int>", workload<TreeSet<int>>);
+    bench.run("std::set<int>", workload<set<int>>);
+    bench.print(cout);
+    return 0;
+}
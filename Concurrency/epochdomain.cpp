@@ -0,0 +1,106 @@
+/**
+ * \file epochdomain.cpp
+ * \author Rachel Lee
+ *
+ * \brief Implementation of epochdomain.hpp
+ */
+
+#include "epochdomain.hpp"
+
+EpochDomain::EpochDomain() :
+    retired_{}, epoch_{0}, pending_{0}
+{
+    // Nothing else to do
+}
+
+EpochDomain::~EpochDomain()
+{
+    for (size_t e = 0; e < EPOCHS; ++e)
+        deleteAll(retired_[e].load());
+}
+
+size_t EpochDomain::shard()
+{
+    // Hand out shards round-robin as threads first show up
+    static std::atomic<size_t> nextShard{0};
+    static thread_local const size_t mine = nextShard++ % SHARDS;
+    return mine;
+}
+
+void EpochDomain::retire(Retirable* garbage)
+{
+    // The caller unlinked garbage with a store that may still be sitting in
+    // its store buffer. Without a full fence we could read an epoch that a
+    // reader has already moved past while it still sees the old link, and
+    // garbage would be freed a step early, under that reader's feet.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // Our own Guard keeps the epoch from moving more than one step past the
+    // label we read here, so the list cannot be freed while we push
+    std::atomic<Retirable*>& list = retired_[epoch_.load() % EPOCHS];
+    garbage->retiredNext_ = list.load();
+    while (!list.compare_exchange_weak(garbage->retiredNext_, garbage)) {
+        // garbage->retiredNext_ now holds the current head; try again
+    }
+
+    if (++pending_ % RECLAIM_INTERVAL == 0)
+        reclaim();
+}
+
+void EpochDomain::reclaim()
+{
+    std::unique_lock<std::mutex> lock{reclaiming_, std::try_to_lock};
+    if (!lock.owns_lock())
+        return;
+
+    size_t epoch = epoch_.load();
+    size_t previous = (epoch + EPOCHS - 1) % EPOCHS;
+    for (size_t s = 0; s < SHARDS; ++s) {
+        if (readers_[previous][s].readers_.load() != 0)
+            return;
+    }
+
+    // Nobody is left in epoch - 1, and nobody older can still be around,
+    // so everything labeled epoch - 1 is unreachable. Its slot is reused
+    // for epoch + 2, which cannot start before we advance again.
+    Retirable* garbage = retired_[previous].exchange(nullptr);
+    epoch_.store(epoch + 1);
+    lock.unlock();
+
+    deleteAll(garbage);
+}
+
+void EpochDomain::deleteAll(Retirable* garbage)
+{
+    while (garbage != nullptr) {
+        Retirable* next = garbage->retiredNext_;
+        delete garbage;
+        garbage = next;
+    }
+}
+
+// --------------------------------------
+// Implementation of EpochDomain::Guard
+// --------------------------------------
+
+EpochDomain::Guard::Guard(EpochDomain& domain) :
+    domain_{domain}, counter_{nullptr}
+{
+    size_t s = shard();
+    for (;;) {
+        size_t epoch = domain_.epoch_.load();
+        counter_ = &domain_.readers_[epoch % EPOCHS][s].readers_;
+        ++*counter_;
+
+        // If the epoch moved on before we were counted, a reclaimer may
+        // already have checked our counter; back out and join the new one
+        if (domain_.epoch_.load() == epoch)
+            return;
+        --*counter_;
+    }
+}
+
+EpochDomain::Guard::~Guard()
+{
+    --*counter_;
+}
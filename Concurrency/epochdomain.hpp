@@ -0,0 +1,119 @@
+/**
+ * \file epochdomain.hpp
+ *
+ * \author Rachel Lee
+ *
+ * \brief Provides EpochDomain, epoch-based reclamation for lock-free readers
+ */
+
+#ifndef EPOCHDOMAIN_HPP_INCLUDED
+#define EPOCHDOMAIN_HPP_INCLUDED 1
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+
+/**
+ * \class EpochDomain
+ *
+ * \brief Defers deleting nodes until no reader can still be looking at them.
+ *
+ * \details Readers hold a Guard while they traverse shared nodes. A writer
+ *          that unlinks a node hands it to retire() instead of deleting it.
+ *          The node is deleted once every Guard that was active at that
+ *          point has been released.
+ *
+ *          The domain tracks a global epoch, and retired nodes are labeled
+ *          with the epoch in which they were retired. The epoch only
+ *          advances from E to E + 1 after every reader from epoch E - 1 has
+ *          left, so nodes labeled E - 1 can be freed at that moment. Reader
+ *          counts are spread over cache-line-sized shards, so readers on
+ *          different threads rarely touch the same line.
+ */
+class EpochDomain {
+public:
+    /**
+     * \struct Retirable
+     * \brief Base class for anything handed to retire().
+     */
+    struct Retirable {
+        virtual ~Retirable() = default;
+
+        Retirable* retiredNext_ = nullptr; ///< Link in a list of retirees
+    };
+
+    /**
+     * \class Guard
+     * \brief Marks the current thread as reading for the Guard's lifetime.
+     */
+    class Guard {
+    public:
+        explicit Guard(EpochDomain& domain);
+        ~Guard();
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+    private:
+        EpochDomain& domain_;
+        std::atomic<size_t>* counter_; ///< Reader count we incremented
+    };
+
+    EpochDomain(); ///< Default constructor
+
+    /**
+     * \brief Deletes everything that was retired and not yet reclaimed.
+     *
+     * \note No Guard may be alive when the domain is destroyed.
+     */
+    ~EpochDomain();
+
+    EpochDomain(const EpochDomain&) = delete;
+    EpochDomain& operator=(const EpochDomain&) = delete;
+
+    /**
+     * \brief Schedules garbage for deletion once no reader can reach it.
+     *
+     * \note Must be called while the calling thread holds a Guard, after
+     *       garbage has been unlinked from the shared structure.
+     */
+    void retire(Retirable* garbage);
+
+    /**
+     * \brief Tries to advance the epoch and deletes whatever became safe.
+     *
+     * \details Never blocks; it gives up if another thread is reclaiming or
+     *          a reader from the previous epoch is still active.
+     */
+    void reclaim();
+
+private:
+    static constexpr size_t EPOCHS = 3;  ///< Epochs that can be in use at once
+    static constexpr size_t SHARDS = 16; ///< Reader counters per epoch
+
+    /// Number of retirements between calls to reclaim()
+    static constexpr size_t RECLAIM_INTERVAL = 64;
+
+    /// A reader count on a cache line of its own.
+    struct alignas(64) Counter {
+        std::atomic<size_t> readers_{0};
+    };
+
+    Counter readers_[EPOCHS][SHARDS];          ///< Active readers per epoch
+    std::atomic<Retirable*> retired_[EPOCHS];  ///< Retirees per epoch label
+    std::atomic<size_t> epoch_;                ///< Current global epoch
+    std::atomic<size_t> pending_;              ///< Retirements since reclaim
+    std::mutex reclaiming_;                    ///< Held while advancing
+
+    /**
+     * \brief Returns the shard used by the calling thread.
+     */
+    static size_t shard();
+
+    /**
+     * \brief Deletes every Retirable in the list starting at garbage.
+     */
+    static void deleteAll(Retirable* garbage);
+};
+
+#endif // EPOCHDOMAIN_HPP_INCLUDED
@@ -14,27 +14,97 @@
 #include <iostream>
 #include <forward_list>
 #include <iterator>
+#include <algorithm>
+#include <new>
 
-template <class T>
-HashSet<T>::~HashSet()
+#include "../Instrumentation/probes.hpp"
+
+template <class T, class Allocator, size_t N>
+HashSet<T, Allocator, N>::HashSet() : HashSet{Allocator()}
+{
+}
+
+template <class T, class Allocator, size_t N>
+HashSet<T, Allocator, N>::HashSet(const Allocator& alloc) :
+    allocator_{alloc}, table_{nullptr}
 {
+    // The table is only built once small_ overflows
+}
+
+template <class T, class Allocator, size_t N>
+HashSet<T, Allocator, N>::~HashSet()
+{
+    if (table_ == nullptr)
+        return;
     for(size_t i = 0; i < numBuckets_; i++) {
-        delete table_[i];
+        deleteChain(table_[i]);
     }
-    delete [] table_;
+    deleteTable(table_, numBuckets_);
 }
 
-template <class T>
-size_t HashSet<T>::size() const
+template <class T, class Allocator, size_t N>
+Allocator HashSet<T, Allocator, N>::get_allocator() const
+{
+    return allocator_;
+}
+
+template <class T, class Allocator, size_t N>
+typename HashSet<T, Allocator, N>::Chain**
+HashSet<T, Allocator, N>::newTable(size_t buckets)
+{
+    TableAllocator alloc{allocator_};
+    Chain** table = std::allocator_traits<TableAllocator>::allocate(alloc,
+                                                                   buckets);
+    std::fill(table, table + buckets, nullptr);
+    return table;
+}
+
+template <class T, class Allocator, size_t N>
+void HashSet<T, Allocator, N>::deleteTable(Chain** table, size_t buckets)
+{
+    TableAllocator alloc{allocator_};
+    std::allocator_traits<TableAllocator>::deallocate(alloc, table, buckets);
+}
+
+template <class T, class Allocator, size_t N>
+typename HashSet<T, Allocator, N>::Chain* HashSet<T, Allocator, N>::newChain()
+{
+    ChainAllocator alloc{allocator_};
+    Chain* chain = std::allocator_traits<ChainAllocator>::allocate(alloc, 1);
+    // The chain's nodes come from our allocator too
+    return ::new (static_cast<void*>(chain)) Chain(allocator_);
+}
+
+template <class T, class Allocator, size_t N>
+void HashSet<T, Allocator, N>::deleteChain(Chain* chain)
+{
+    if (chain == nullptr)
+        return;
+    ChainAllocator alloc{allocator_};
+    chain->~Chain();
+    std::allocator_traits<ChainAllocator>::deallocate(alloc, chain, 1);
+}
+
+template <class T, class Allocator, size_t N>
+size_t HashSet<T, Allocator, N>::size() const
 {
     return size_;
 }
 
-template <class T>
-void HashSet<T>::insert(const T &item)
+template <class T, class Allocator, size_t N>
+void HashSet<T, Allocator, N>::insert(const T &item)
 {
-    ++size_;
-    ++collisions_;
+    DATASTRUCTURES_PROBE("HashSet::insert");
+    if (table_ == nullptr) {
+        if (small_.contains(item))
+            return;
+        if (!small_.full()) {
+            small_.push_back(item);
+            ++size_;
+            return;
+        }
+        moveToTable();
+    }
 
     size_t hashed = myhash(item);
     size_t bucket = hashed % buckets();
@@ -43,10 +113,14 @@ void HashSet<T>::insert(const T &item)
 
     // If the bucket is empty
     if (!chain) {
-        chain = new std::forward_list<T>;
-        --collisions_;
+        chain = newChain();
+    } else if (std::find(chain->begin(), chain->end(), item) != chain->end()) {
+        return;
+    } else {
+        ++collisions_;
     }
-    
+
+    ++size_;
     chain->push_front(item);
 
     size_t chainSize = std::distance(chain->begin(), chain->end());
@@ -59,15 +133,31 @@ void HashSet<T>::insert(const T &item)
     }
 }
 
-template <class T>
-bool HashSet<T>::overloaded() const
+template <class T, class Allocator, size_t N>
+void HashSet<T, Allocator, N>::moveToTable()
+{
+    table_ = newTable(numBuckets_);
+
+    // Reinsert like resize() does, so the statistics cover these items too
+    size_ = 0;
+    for (const T& item : small_)
+        insert(item);
+    small_.clear();
+}
+
+template <class T, class Allocator, size_t N>
+bool HashSet<T, Allocator, N>::overloaded() const
 {
     return double(size_)/double(numBuckets_) >= LOAD_FACTOR;
 }
 
-template <class T>
-bool HashSet<T>::exists(const T &item) const
+template <class T, class Allocator, size_t N>
+bool HashSet<T, Allocator, N>::exists(const T &item) const
 {
+    DATASTRUCTURES_PROBE("HashSet::exists");
+    if (table_ == nullptr)
+        return small_.contains(item);
+
     size_t hashed = myhash(item);
     size_t bucket = hashed % buckets();
 
@@ -85,8 +175,8 @@ bool HashSet<T>::exists(const T &item) const
     return false;
 }
 
-template <class T>
-void HashSet<T>::resize() 
+template <class T, class Allocator, size_t N>
+void HashSet<T, Allocator, N>::resize() 
 {
     maximalChainSize_ = 0;
     collisions_ = 0;
@@ -94,52 +184,81 @@ void HashSet<T>::resize()
 
     // Make a copy of the old table
     size_t oldSize = numBuckets_;
-    std::forward_list<T>** oldTable = table_;
+    Chain** oldTable = table_;
 
     // Resize the original table and initialize its elements to be null pointers
     numBuckets_ = 2 * oldSize;
-    table_ = new std::forward_list<T>*[numBuckets_]();
+    table_ = newTable(numBuckets_);
 
     // Copy over the elements
     for(size_t i = 0; i < oldSize; ++i) {
         if(oldTable[i]) {
             insertWholeList(oldTable[i]);
         }
-        delete oldTable[i];
+        deleteChain(oldTable[i]);
     }
-    delete[] oldTable;
+    deleteTable(oldTable, oldSize);
 
     ++reallocations_;
 }
 
-template <class T>
-void HashSet<T>::insertWholeList(std::forward_list<T>* list)
+template <class T, class Allocator, size_t N>
+void HashSet<T, Allocator, N>::insertWholeList(Chain* list)
 {
     for(auto i = list->begin(); i != list->end(); ++i) {
         insert(*i);
     }
 }
 
-template <class T>
-size_t HashSet<T>::buckets() const
+template <class T, class Allocator, size_t N>
+size_t HashSet<T, Allocator, N>::buckets() const
 {
     return numBuckets_;
 }
 
-template <class T>
-size_t HashSet<T>::reallocations() const
+template <class T, class Allocator, size_t N>
+size_t HashSet<T, Allocator, N>::reallocations() const
 {
     return reallocations_;
 }
 
-template <class T>
-size_t HashSet<T>::collisions() const
+template <class T, class Allocator, size_t N>
+size_t HashSet<T, Allocator, N>::collisions() const
 {
     return collisions_;
 }
 
-template <class T>
-size_t HashSet<T>::maximal() const
+template <class T, class Allocator, size_t N>
+size_t HashSet<T, Allocator, N>::maximal() const
 {
     return maximalChainSize_;
 }
+
+template <class T, class Allocator, size_t N>
+bool HashSet<T, Allocator, N>::consistent() const
+{
+    if (table_ == nullptr) {
+        if (size_ != small_.size())
+            return false;
+        for (const T* i = small_.begin(); i != small_.end(); ++i) {
+            if (std::find(small_.begin(), i, *i) != i)
+                return false;
+        }
+        return true;
+    }
+
+    size_t counted = 0;
+    for (size_t bucket = 0; bucket < numBuckets_; ++bucket) {
+        const Chain* chain = table_[bucket];
+        if (chain == nullptr)
+            continue;
+        for (auto i = chain->begin(); i != chain->end(); ++i) {
+            ++counted;
+            // Duplicates hash alike, so they could only share this chain
+            if (myhash(*i) % numBuckets_ != bucket
+                || std::find(std::next(i), chain->end(), *i) != chain->end())
+                return false;
+        }
+    }
+    return counted == size_ && small_.size() == 0;
+}
@@ -13,14 +13,30 @@
 // Header files that are needed to typecheck the class declaration
 #include <cstddef>
 #include <forward_list>
+#include <memory>
+
+#include "../Memory/smallbuffer.hpp"
 
 
 // Templated interfaces (e.g., the HashSet class declarations)
-template <class T>
+//
+// The table and every chain come from Allocator, so with a
+// std::pmr::polymorphic_allocator a HashSet can live in a request's arena.
+//
+// The first N items are kept inline and found by a linear scan; the table
+// is only built, and the items moved into it, when item N + 1 arrives.
+// With the default N = 0 the table is built on the first insert.
+template <class T, class Allocator = std::allocator<T>, size_t N = 0>
 class HashSet {
 
 public:
-    HashSet() = default; ///< Default constructor
+    /// Bytes in one chain node (a link and an item), for sizing node pools
+    static constexpr size_t NODE_SIZE =
+        (sizeof(void*) + sizeof(T) + alignof(T) - 1) / alignof(T) * alignof(T);
+
+    HashSet(); ///< Default constructor
+
+    explicit HashSet(const Allocator& alloc); ///< Allocates from alloc
 
     ~HashSet(); ///< Destructor
     
@@ -30,11 +46,12 @@ public:
 
     size_t size() const; ///< Number of items in the hash table
 
+    Allocator get_allocator() const; ///< Where the table and chains live
+
     /**
      * \brief Adds item to the hash table. 
      *
-     * \note The function's behavior is undefined if the item has already been
-     *       added to the table.
+     * \note Adding an item that is already in the table does nothing.
      */
     void insert(const T &item);
 
@@ -66,7 +83,23 @@ public:
      */
     size_t maximal() const;
 
+    /**
+     * \brief Returns true if the table's bookkeeping agrees with its
+     *        contents: size() counts every item, each item sits in the
+     *        bucket it hashes to, and no item appears twice.
+     *
+     * \details Walks the whole table, so it is meant for checks in
+     *          debugging and stress runs rather than normal use.
+     */
+    bool consistent() const;
+
 private:
+    using Chain = std::forward_list<T, Allocator>;
+    using ChainAllocator = typename std::allocator_traits<Allocator>::
+        template rebind_alloc<Chain>;
+    using TableAllocator = typename std::allocator_traits<Allocator>::
+        template rebind_alloc<Chain*>;
+
     const static int LOAD_FACTOR = 4; 
 
     size_t size_ = 0;
@@ -77,13 +110,31 @@ private:
     
     void resize();
 
-    void insertWholeList(std::forward_list<T>* list);
+    void insertWholeList(Chain* list);
+
+    void moveToTable(); ///< Leaves small mode for the table
 
     bool overloaded() const;
 
-    std::forward_list<T>** table_ = new std::forward_list<T>*[numBuckets_]();
+    Chain** newTable(size_t buckets); ///< An array of empty buckets
+
+    void deleteTable(Chain** table, size_t buckets);
+
+    Chain* newChain();
+
+    void deleteChain(Chain* chain);
+
+    Allocator allocator_;
+
+    Chain** table_; ///< Null while the items fit in small_
+
+    SmallBuffer<T, N> small_;
 };
 
+/// A HashSet that keeps up to N items inline.
+template <class T, size_t N, class Allocator = std::allocator<T>>
+using SmallHashSet = HashSet<T, Allocator, N>;
+
 #include "hashset-private.hpp"
 
 #endif
\ No newline at end of file
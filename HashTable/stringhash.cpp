@@ -62,12 +62,9 @@ size_t rsHash(const std::string& str)
 size_t thirtyThreeHash(const string& str)
 {
     unsigned long hash = 5381;
-    auto i = str.begin();
-    int c = *i;
 
-    while (i != str.end()) {
+    for (const char& c : str) {
         hash = ((hash << 5) + hash) + c; /* hash * 33 + c */
-        c = *(i++);
     }
 
     return hash;
@@ -0,0 +1,281 @@
+/*
+ * \file probes.cpp
+ * \authors Rachel Lee
+ * \brief Implemenation of PerfCounters and the probes.
+ */
+
+#include "probes.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+#include <mutex>
+
+#if defined(__linux__)
+#include <linux/perf_event.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+// --------------------------------------
+// Counting allocations
+// --------------------------------------
+
+// Trivial, so it is safe to touch from operator new at any point in a
+// thread's life
+static thread_local uint64_t allocationCount = 0;
+
+void PerfCounters::countAllocation()
+{
+    ++allocationCount;
+}
+
+// --------------------------------------
+// Implementation of CounterSample
+// --------------------------------------
+
+CounterSample CounterSample::operator-(const CounterSample& rhs) const
+{
+    CounterSample difference;
+    difference.cycles = cycles - rhs.cycles;
+    difference.llcMisses = llcMisses - rhs.llcMisses;
+    difference.branchMisses = branchMisses - rhs.branchMisses;
+    difference.allocations = allocations - rhs.allocations;
+    return difference;
+}
+
+CounterSample& CounterSample::operator+=(const CounterSample& rhs)
+{
+    cycles += rhs.cycles;
+    llcMisses += rhs.llcMisses;
+    branchMisses += rhs.branchMisses;
+    allocations += rhs.allocations;
+    return *this;
+}
+
+// --------------------------------------
+// Implementation of PerfCounters
+// --------------------------------------
+
+PerfCounters& PerfCounters::thisThread()
+{
+    static thread_local PerfCounters counters;
+    return counters;
+}
+
+PerfCounters::PerfCounters()
+{
+#if defined(__linux__)
+    static const uint64_t CONFIGS[HARDWARE_COUNTERS] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES};
+    long pageSize = sysconf(_SC_PAGESIZE);
+
+    for (size_t i = 0; i < HARDWARE_COUNTERS; ++i) {
+        // Separate events rather than a group, so one the CPU lacks
+        // doesn't take the others down with it
+        perf_event_attr attr;
+        memset(&attr, 0, sizeof attr);
+        attr.type = PERF_TYPE_HARDWARE;
+        attr.size = sizeof attr;
+        attr.config = CONFIGS[i];
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        fds_[i] = int(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+        pages_[i] = nullptr;
+        if (fds_[i] < 0)
+            continue;
+
+        // The first page tells us whether rdpmc is allowed
+        void* page = mmap(nullptr, size_t(pageSize), PROT_READ, MAP_SHARED,
+                          fds_[i], 0);
+        if (page != MAP_FAILED)
+            pages_[i] = page;
+    }
+#else
+    for (size_t i = 0; i < HARDWARE_COUNTERS; ++i) {
+        fds_[i] = -1;
+        pages_[i] = nullptr;
+    }
+#endif
+}
+
+PerfCounters::~PerfCounters()
+{
+#if defined(__linux__)
+    long pageSize = sysconf(_SC_PAGESIZE);
+    for (size_t i = 0; i < HARDWARE_COUNTERS; ++i) {
+        if (pages_[i] != nullptr)
+            munmap(pages_[i], size_t(pageSize));
+        if (fds_[i] >= 0)
+            close(fds_[i]);
+    }
+#endif
+}
+
+bool PerfCounters::available(Counter counter) const
+{
+    return counter < HARDWARE_COUNTERS && fds_[counter] >= 0;
+}
+
+uint64_t PerfCounters::readCounter(size_t counter) const
+{
+#if defined(__linux__)
+    if (fds_[counter] < 0)
+        return 0;
+
+#if defined(__x86_64__) || defined(__i386__)
+    // The kernel's recipe for reading a counter from user space: retry
+    // until the page's sequence number is the same before and after
+    if (pages_[counter] != nullptr) {
+        volatile perf_event_mmap_page* page =
+            static_cast<perf_event_mmap_page*>(pages_[counter]);
+        uint32_t sequence;
+        uint64_t count;
+        bool inUserSpace;
+        do {
+            sequence = page->lock;
+            atomic_signal_fence(memory_order_seq_cst);
+            uint32_t index = page->index;
+            count = uint64_t(page->offset);
+            inUserSpace = page->cap_user_rdpmc && index != 0;
+            if (inUserSpace) {
+                uint32_t low, high;
+                asm volatile("rdpmc" : "=a"(low), "=d"(high)
+                                     : "c"(index - 1));
+                // Sign-extend the counter from its real width
+                uint16_t width = page->pmc_width;
+                int64_t pmc = int64_t(uint64_t(high) << 32 | low);
+                pmc = int64_t(uint64_t(pmc) << (64 - width)) >> (64 - width);
+                count += uint64_t(pmc);
+            }
+            atomic_signal_fence(memory_order_seq_cst);
+        } while (page->lock != sequence);
+        if (inUserSpace)
+            return count;
+    }
+#endif
+
+    uint64_t count = 0;
+    if (::read(fds_[counter], &count, sizeof count) != ssize_t(sizeof count))
+        return 0;
+    return count;
+#else
+    (void)counter;
+    return 0;
+#endif
+}
+
+CounterSample PerfCounters::read() const
+{
+    CounterSample sample;
+    sample.cycles = readCounter(CYCLES);
+    sample.llcMisses = readCounter(LLC_MISSES);
+    sample.branchMisses = readCounter(BRANCH_MISSES);
+    sample.allocations = allocationCount;
+    return sample;
+}
+
+uint64_t PerfCounters::allocations()
+{
+    return allocationCount;
+}
+
+// --------------------------------------
+// Probes
+// --------------------------------------
+
+// Names of all the sites, indexed like each thread's totals
+static mutex siteLock;
+static vector<const char*>& siteNames()
+{
+    static vector<const char*> names;
+    return names;
+}
+
+// This thread's totals, indexed by site; grows as sites are first used
+struct ThreadTotals {
+    vector<uint64_t> calls;
+    vector<CounterSample> counters;
+    bool inProbe = false;
+};
+
+static ThreadTotals& threadTotals()
+{
+    static thread_local ThreadTotals totals;
+    return totals;
+}
+
+ProbeSite::ProbeSite(const char* name)
+{
+    lock_guard<mutex> guard{siteLock};
+    index_ = siteNames().size();
+    siteNames().push_back(name);
+}
+
+ProbeScope::ProbeScope(const ProbeSite& site)
+    : site_{site}, outermost_{!threadTotals().inProbe}
+{
+    if (!outermost_)
+        return;
+    threadTotals().inProbe = true;
+    // Read last, so the probe's own work is mostly left out
+    start_ = PerfCounters::thisThread().read();
+}
+
+ProbeScope::~ProbeScope()
+{
+    if (!outermost_)
+        return;
+    CounterSample spent = PerfCounters::thisThread().read() - start_;
+
+    ThreadTotals& totals = threadTotals();
+    if (totals.calls.size() <= site_.index_) {
+        totals.calls.resize(site_.index_ + 1);
+        totals.counters.resize(site_.index_ + 1);
+    }
+    ++totals.calls[site_.index_];
+    totals.counters[site_.index_] += spent;
+    totals.inProbe = false;
+}
+
+vector<ProbeTotals> probeTotals()
+{
+    ThreadTotals& totals = threadTotals();
+    vector<ProbeTotals> merged;
+    lock_guard<mutex> guard{siteLock};
+
+    for (size_t i = 0; i < totals.calls.size(); ++i) {
+        if (totals.calls[i] == 0)
+            continue;
+        // Sites sharing a name (template instantiations) are merged
+        const char* name = siteNames()[i];
+        auto same = find_if(merged.begin(), merged.end(),
+                            [name](const ProbeTotals& probe) {
+                                return probe.name == name;
+                            });
+        if (same == merged.end()) {
+            merged.push_back(ProbeTotals{});
+            same = merged.end() - 1;
+            same->name = name;
+        }
+        same->calls += totals.calls[i];
+        same->counters += totals.counters[i];
+    }
+
+    sort(merged.begin(), merged.end(),
+         [](const ProbeTotals& a, const ProbeTotals& b) {
+             return a.name < b.name;
+         });
+    return merged;
+}
+
+void resetProbeTotals()
+{
+    ThreadTotals& totals = threadTotals();
+    fill(totals.calls.begin(), totals.calls.end(), 0);
+    fill(totals.counters.begin(), totals.counters.end(), CounterSample{});
+}
@@ -0,0 +1,171 @@
+/**
+ * \file probes.hpp
+ * \authors Rachel Lee
+ * \brief Hardware performance counters and per-operation probes for the
+ *        containers.
+ *
+ * \details Containers mark their operations with DATASTRUCTURES_PROBE,
+ *          which expands to nothing unless DATASTRUCTURES_PROBES is
+ *          defined (the CMake option of the same name). When it is defined,
+ *          each marked call reads the calling thread's counters on entry
+ *          and exit and adds the difference to that operation's totals.
+ *          Calls made while a probe is already open, such as the inserts a
+ *          HashSet does while resizing, count towards the outer call only.
+ */
+
+#ifndef PROBES_HPP_INCLUDED
+#define PROBES_HPP_INCLUDED 1
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * \brief Counter readings, or the difference between two readings.
+ */
+struct CounterSample {
+    std::uint64_t cycles = 0;        ///< CPU cycles in user space
+    std::uint64_t llcMisses = 0;     ///< Last-level cache misses
+    std::uint64_t branchMisses = 0;  ///< Mispredicted branches
+    std::uint64_t allocations = 0;   ///< Calls to operator new, if counted
+
+    CounterSample operator-(const CounterSample& rhs) const;
+    CounterSample& operator+=(const CounterSample& rhs);
+};
+
+/**
+ * \class PerfCounters
+ *
+ * \brief The calling thread's cycle, LLC-miss and branch-miss counters,
+ *        from Linux's perf_event_open, plus its allocation count.
+ *
+ * \details The hardware counters are read with rdpmc where the kernel
+ *          allows it, which avoids a system call per reading. Counters the
+ *          kernel won't give us (no PMU, perf_event_paranoid too high, not
+ *          Linux) read as zero and are reported as unavailable.
+ */
+class PerfCounters {
+public:
+    /// Which counters a reading holds
+    enum Counter { CYCLES, LLC_MISSES, BRANCH_MISSES, HARDWARE_COUNTERS };
+
+    /**
+     * \brief Returns the calling thread's counters, opening them on first
+     *        use.
+     */
+    static PerfCounters& thisThread();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    /**
+     * \brief Returns whether counter could be opened.
+     */
+    bool available(Counter counter) const;
+
+    /**
+     * \brief Reads every counter.
+     */
+    CounterSample read() const;
+
+    /**
+     * \brief Returns the number of calls to operator new on this thread.
+     *
+     * \details Counted by the replacement operator new in
+     *          Benchmark/countingnew.cpp, so it covers every allocation,
+     *          whoever makes it. Only the benchmarks link that in; in other
+     *          programs this stays 0.
+     */
+    static std::uint64_t allocations();
+
+    /**
+     * \brief Adds one to this thread's allocation count; called by the
+     *        counting operator new.
+     */
+    static void countAllocation();
+
+private:
+    PerfCounters();
+    ~PerfCounters();
+
+    std::uint64_t readCounter(size_t counter) const;
+
+    int fds_[HARDWARE_COUNTERS];
+    void* pages_[HARDWARE_COUNTERS];
+};
+
+/**
+ * \brief What the probes of one operation have added up.
+ */
+struct ProbeTotals {
+    std::string name;        ///< The operation, e.g. "HashSet::insert"
+    std::uint64_t calls = 0; ///< Outermost calls made
+    CounterSample counters;  ///< Summed over those calls
+};
+
+/**
+ * \class ProbeSite
+ *
+ * \brief One place in the code that DATASTRUCTURES_PROBE marks.
+ *
+ * \details Sites with the same name, e.g. from different instantiations of
+ *          a template, are reported together.
+ */
+class ProbeSite {
+public:
+    explicit ProbeSite(const char* name);
+
+private:
+    friend class ProbeScope;
+    friend std::vector<ProbeTotals> probeTotals();
+
+    size_t index_;
+};
+
+/**
+ * \class ProbeScope
+ *
+ * \brief Adds the counter readings between its construction and
+ *        destruction to its site's totals for this thread.
+ */
+class ProbeScope {
+public:
+    explicit ProbeScope(const ProbeSite& site);
+    ~ProbeScope();
+
+    ProbeScope(const ProbeScope&) = delete;
+    ProbeScope& operator=(const ProbeScope&) = delete;
+
+private:
+    const ProbeSite& site_;
+    bool outermost_;
+    CounterSample start_;
+};
+
+/**
+ * \brief Returns this thread's totals for every operation probed so far,
+ *        sorted by name.
+ */
+std::vector<ProbeTotals> probeTotals();
+
+/**
+ * \brief Zeroes this thread's totals.
+ */
+void resetProbeTotals();
+
+#ifdef DATASTRUCTURES_PROBES
+#define DATASTRUCTURES_PROBE_JOIN(a, b) a##b
+#define DATASTRUCTURES_PROBE_NAMED(name, line)                              \
+    static const ProbeSite DATASTRUCTURES_PROBE_JOIN(probeSite, line){name}; \
+    ProbeScope DATASTRUCTURES_PROBE_JOIN(probeScope, line)                   \
+    {                                                                        \
+        DATASTRUCTURES_PROBE_JOIN(probeSite, line)                           \
+    }
+/// Probes the rest of the enclosing block as operation name
+#define DATASTRUCTURES_PROBE(name) DATASTRUCTURES_PROBE_NAMED(name, __LINE__)
+#else
+#define DATASTRUCTURES_PROBE(name) ((void)0)
+#endif
+
+#endif // PROBES_HPP_INCLUDED
@@ -0,0 +1,126 @@
+/*
+ * \file concurrentintqueue.cpp
+ * \authors Rachel Lee
+ * \brief Implemenation of ConcurrentIntQueue, a lock-free queue of ints.
+ */
+
+#include "concurrentintqueue.hpp"
+
+using namespace std;
+
+ConcurrentIntQueue::ConcurrentIntQueue()
+{
+    Element* dummy = new Element{0};
+    front_.store(dummy);
+    back_.store(dummy);
+}
+
+
+ConcurrentIntQueue::~ConcurrentIntQueue()
+{
+    Element* here = front_.load();
+    while (here != nullptr) {
+        Element* next = here->next_.load();
+        delete here;
+        here = next;
+    }
+}
+
+
+void ConcurrentIntQueue::push_back(int pushee)
+{
+    Element* last = new Element{pushee};
+    EpochDomain::Guard guard{epochs_};
+
+    for (;;) {
+        Element* back = back_.load();
+        Element* next = back->next_.load();
+        if (back != back_.load())
+            continue;
+
+        if (next == nullptr) {
+            // Link in after the real last Element, then try to swing back_;
+            // if we lose that race someone else has already helped
+            if (back->next_.compare_exchange_weak(next, last)) {
+                back_.compare_exchange_strong(back, last);
+                return;
+            }
+        } else {
+            // back_ is lagging behind; help it along and retry
+            back_.compare_exchange_strong(back, next);
+        }
+    }
+}
+
+
+bool ConcurrentIntQueue::try_pop_front(int& popped)
+{
+    return try_pop_many(&popped, 1) == 1;
+}
+
+
+size_t ConcurrentIntQueue::try_pop_many(int* popped, size_t max)
+{
+    if (max == 0)
+        return 0;
+
+    EpochDomain::Guard guard{epochs_};
+
+    for (;;) {
+        Element* front = front_.load();
+
+        // Take up to max values; last becomes the new dummy. They are only
+        // copied out once the CAS below has made them ours.
+        size_t count = 0;
+        Element* last = front;
+        while (count < max) {
+            Element* next = last->next_.load();
+            if (next == nullptr)
+                break;
+            ++count;
+            last = next;
+        }
+        if (count == 0)
+            return 0;
+
+        // back_ must not be left pointing at an Element we are about to
+        // retire, so push it past any that it still points at
+        for (Element* back = back_.load(); ; back = back_.load()) {
+            bool behind = false;
+            for (Element* here = front; here != last; here = here->next_.load())
+                behind = behind || here == back;
+            if (!behind)
+                break;
+            back_.compare_exchange_strong(back, back->next_.load());
+        }
+
+        if (front_.compare_exchange_strong(front, last)) {
+            // Our guard keeps the Elements alive while we read them
+            size_t i = 0;
+            for (Element* here = front; here != last; ) {
+                Element* next = here->next_.load();
+                popped[i++] = next->value_;
+                epochs_.retire(here);
+                here = next;
+            }
+            return count;
+        }
+    }
+}
+
+
+bool ConcurrentIntQueue::empty() const
+{
+    EpochDomain::Guard guard{epochs_};
+    return front_.load()->next_.load() == nullptr;
+}
+
+// --------------------------------------
+// Implementation of ConcurrentIntQueue::Element
+// --------------------------------------
+
+ConcurrentIntQueue::Element::Element(int value)
+    : value_{value}, next_{nullptr}
+{
+    // Nothing else to do
+}
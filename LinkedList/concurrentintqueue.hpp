@@ -0,0 +1,93 @@
+/**
+ * \file concurrentintqueue.hpp
+ * \authors Rachel Lee
+ * \brief A lock-free FIFO queue of ints for many producers and consumers.
+ */
+
+#ifndef CONCURRENTINTQUEUE_HPP_INCLUDED
+#define CONCURRENTINTQUEUE_HPP_INCLUDED 1
+
+#include <atomic>
+#include <cstddef>
+
+#include "../Concurrency/epochdomain.hpp"
+
+/**
+ * \class ConcurrentIntQueue
+ *
+ * \brief A Michael-Scott queue: a linked list of Elements with a dummy
+ *        Element at the front, where producers push_back() and consumers
+ *        pop from the front without taking locks.
+ *
+ * \details Popped Elements are handed to an EpochDomain, so a thread that
+ *          is still looking at one never sees it freed.
+ */
+class ConcurrentIntQueue {
+
+public:
+
+    /**
+     * \brief The default constructor for the ConcurrentIntQueue.
+     */
+    ConcurrentIntQueue();
+
+    /**
+     * \brief The destructor for the ConcurrentIntQueue.
+     *
+     * \note No other thread may be using the queue.
+     */
+    ~ConcurrentIntQueue();
+
+    ConcurrentIntQueue(const ConcurrentIntQueue&) = delete;
+    ConcurrentIntQueue& operator=(const ConcurrentIntQueue&) = delete;
+
+    /**
+     * \brief Pushes a value onto the end of the queue.
+     */
+    void push_back(int pushee);
+
+    /**
+     * \brief Removes the first value from the queue, if there is one.
+     *
+     * \returns false if the queue was empty, leaving popped unchanged.
+     */
+    bool try_pop_front(int& popped);
+
+    /**
+     * \brief Removes up to max values from the front of the queue, in
+     *        order, with a single atomic update of the front.
+     *
+     * \returns The number of values written to popped; the rest of
+     *          popped is left unchanged.
+     */
+    size_t try_pop_many(int* popped, size_t max);
+
+    /**
+     * \brief Returns whether the queue was empty at some point during the
+     *        call.
+     */
+    bool empty() const;
+
+private:
+    /***
+     * \struct Element
+     *
+     * \brief The queue is stored as a linked list of Elements.
+     */
+    struct Element : EpochDomain::Retirable {
+        int value_;
+        std::atomic<Element*> next_;
+
+        explicit Element(int value);
+    };
+
+    /// The dummy Element; the values are in the Elements after it
+    alignas(64) std::atomic<Element*> front_;
+
+    /// The last Element, or (briefly) the one before it
+    alignas(64) std::atomic<Element*> back_;
+
+    mutable EpochDomain epochs_;  ///< Keeps popped Elements alive for readers
+};
+
+#endif // CONCURRENTINTQUEUE_HPP_INCLUDED
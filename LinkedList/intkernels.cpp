@@ -0,0 +1,149 @@
+/*
+ * \file intkernels.cpp
+ * \authors Rachel Lee
+ * \brief Implementation of intkernels.hpp
+ */
+
+#include "intkernels.hpp"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#endif
+
+long long sumInts(const int* values, size_t n)
+{
+    long long sum = 0;
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    // Widen to 64 bits before adding so the lanes cannot overflow
+    __m256i lanes = _mm256_setzero_si256();
+    for (; i + 8 <= n; i += 8) {
+        __m256i block = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(values + i));
+        lanes = _mm256_add_epi64(lanes,
+            _mm256_cvtepi32_epi64(_mm256_castsi256_si128(block)));
+        lanes = _mm256_add_epi64(lanes,
+            _mm256_cvtepi32_epi64(_mm256_extracti128_si256(block, 1)));
+    }
+    alignas(32) long long partial[4];
+    _mm256_store_si256(reinterpret_cast<__m256i*>(partial), lanes);
+    sum = partial[0] + partial[1] + partial[2] + partial[3];
+#elif defined(__SSE2__)
+    // SSE2 has no sign extension, so split the sum of the low 16 bits from
+    // the sum of the (signed) high 16 bits, each of which fits in an int
+    // for up to 2^15 values at a time
+    while (i + 4 <= n) {
+        size_t stop = n - i > 32768 ? i + 32768 : n;
+        __m128i low = _mm_setzero_si128();
+        __m128i high = _mm_setzero_si128();
+        for (; i + 4 <= stop; i += 4) {
+            __m128i block = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(values + i));
+            low = _mm_add_epi32(low, _mm_and_si128(block, _mm_set1_epi32(0xFFFF)));
+            high = _mm_add_epi32(high, _mm_srai_epi32(block, 16));
+        }
+        alignas(16) int lows[4];
+        alignas(16) int highs[4];
+        _mm_store_si128(reinterpret_cast<__m128i*>(lows), low);
+        _mm_store_si128(reinterpret_cast<__m128i*>(highs), high);
+        for (int lane = 0; lane < 4; ++lane)
+            sum += (long long)(unsigned)lows[lane]
+                   + (long long)highs[lane] * 65536;
+    }
+#endif
+
+    for (; i < n; ++i)
+        sum += values[i];
+    return sum;
+}
+
+size_t countInts(const int* values, size_t n, int wanted)
+{
+    size_t count = 0;
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    __m256i needle = _mm256_set1_epi32(wanted);
+    for (; i + 8 <= n; i += 8) {
+        __m256i block = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(values + i));
+        int mask = _mm256_movemask_ps(
+            _mm256_castsi256_ps(_mm256_cmpeq_epi32(block, needle)));
+        count += __builtin_popcount(mask);
+    }
+#elif defined(__SSE2__)
+    __m128i needle = _mm_set1_epi32(wanted);
+    for (; i + 4 <= n; i += 4) {
+        __m128i block = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(values + i));
+        int mask = _mm_movemask_ps(
+            _mm_castsi128_ps(_mm_cmpeq_epi32(block, needle)));
+        count += __builtin_popcount(mask);
+    }
+#endif
+
+    for (; i < n; ++i)
+        count += size_t(values[i] == wanted);
+    return count;
+}
+
+size_t findInt(const int* values, size_t n, int wanted)
+{
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    __m256i needle = _mm256_set1_epi32(wanted);
+    for (; i + 8 <= n; i += 8) {
+        __m256i block = _mm256_loadu_si256(
+            reinterpret_cast<const __m256i*>(values + i));
+        int mask = _mm256_movemask_ps(
+            _mm256_castsi256_ps(_mm256_cmpeq_epi32(block, needle)));
+        if (mask != 0)
+            return i + __builtin_ctz(mask);
+    }
+#elif defined(__SSE2__)
+    __m128i needle = _mm_set1_epi32(wanted);
+    for (; i + 4 <= n; i += 4) {
+        __m128i block = _mm_loadu_si128(
+            reinterpret_cast<const __m128i*>(values + i));
+        int mask = _mm_movemask_ps(
+            _mm_castsi128_ps(_mm_cmpeq_epi32(block, needle)));
+        if (mask != 0)
+            return i + __builtin_ctz(mask);
+    }
+#endif
+
+    for (; i < n; ++i) {
+        if (values[i] == wanted)
+            return i;
+    }
+    return n;
+}
+
+bool equalInts(const int* a, const int* b, size_t n)
+{
+    size_t i = 0;
+
+#if defined(__AVX2__)
+    for (; i + 8 <= n; i += 8) {
+        __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(a + i));
+        __m256i y = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+        if (_mm256_movemask_epi8(_mm256_cmpeq_epi32(x, y)) != -1)
+            return false;
+    }
+#elif defined(__SSE2__)
+    for (; i + 4 <= n; i += 4) {
+        __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a + i));
+        __m128i y = _mm_loadu_si128(reinterpret_cast<const __m128i*>(b + i));
+        if (_mm_movemask_epi8(_mm_cmpeq_epi32(x, y)) != 0xFFFF)
+            return false;
+    }
+#endif
+
+    for (; i < n; ++i) {
+        if (a[i] != b[i])
+            return false;
+    }
+    return true;
+}
@@ -0,0 +1,38 @@
+/**
+ * \file intkernels.hpp
+ * \authors Rachel Lee
+ * \brief Bulk operations over contiguous runs of ints.
+ *
+ * \details The list classes call these on each contiguous piece of their
+ *          storage. They use AVX2 or SSE2 when the compiler targets them
+ *          and plain loops otherwise.
+ */
+
+#ifndef INTKERNELS_HPP_INCLUDED
+#define INTKERNELS_HPP_INCLUDED 1
+
+#include <cstddef>
+
+/**
+ * \brief Returns the sum of values[0, n), without overflowing for any
+ *        n that fits in memory.
+ */
+long long sumInts(const int* values, size_t n);
+
+/**
+ * \brief Returns how many of values[0, n) equal wanted.
+ */
+size_t countInts(const int* values, size_t n, int wanted);
+
+/**
+ * \brief Returns the index of the first of values[0, n) that equals wanted,
+ *        or n if there is none.
+ */
+size_t findInt(const int* values, size_t n, int wanted);
+
+/**
+ * \brief Returns whether a[0, n) and b[0, n) hold the same values.
+ */
+bool equalInts(const int* a, const int* b, size_t n);
+
+#endif // INTKERNELS_HPP_INCLUDED
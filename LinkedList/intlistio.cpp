@@ -0,0 +1,505 @@
+/*
+ * \file intlistio.cpp
+ * \authors Rachel Lee
+ * \brief Implemenation of the IntList binary format: IntListWriter,
+ *        IntListReader, save(), load() and IntListView.
+ */
+
+#include "intlistio.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+using namespace std;
+
+// --------------------------------------
+// Encoding helpers
+// --------------------------------------
+
+/// Bytes in a file header
+static constexpr size_t HEADER_SIZE = 16;
+
+/// Version written into, and expected in, a file header
+static constexpr uint8_t VERSION = 1;
+
+/// Longest varint we write: a zigzagged 33-bit delta
+static constexpr size_t MAX_VARINT = 5;
+
+/// Longest encoding of one value in any encoding
+static constexpr size_t MAX_ENCODED = MAX_VARINT;
+
+static void putUint32(unsigned char* out, uint32_t value)
+{
+    for (size_t i = 0; i < 4; ++i)
+        out[i] = static_cast<unsigned char>(value >> (8 * i));
+}
+
+static uint32_t getUint32(const unsigned char* in)
+{
+    return uint32_t(in[0]) | uint32_t(in[1]) << 8 | uint32_t(in[2]) << 16
+           | uint32_t(in[3]) << 24;
+}
+
+static void putHeader(unsigned char* out, IntListEncoding encoding,
+                      uint64_t count)
+{
+    memcpy(out, "ILST", 4);
+    out[4] = VERSION;
+    out[5] = static_cast<unsigned char>(encoding);
+    out[6] = out[7] = 0;
+    putUint32(out + 8, uint32_t(count));
+    putUint32(out + 12, uint32_t(count >> 32));
+}
+
+// Returns false if in isn't a header we understand
+static bool getHeader(const unsigned char* in, IntListEncoding& encoding,
+                      uint64_t& count)
+{
+    if (memcmp(in, "ILST", 4) != 0 || in[4] != VERSION
+        || in[5] > uint8_t(IntListEncoding::DELTA_VARINT))
+        return false;
+    encoding = IntListEncoding(in[5]);
+    count = uint64_t(getUint32(in + 8)) | uint64_t(getUint32(in + 12)) << 32;
+    return true;
+}
+
+// Writes value's encoding at out and returns where it ends
+static unsigned char* encode(unsigned char* out, IntListEncoding encoding,
+                             int value, int& previous)
+{
+    if (encoding == IntListEncoding::RAW) {
+        putUint32(out, uint32_t(value));
+        return out + 4;
+    }
+
+    // Zigzag the delta so small steps either way take few bytes
+    int64_t delta = int64_t(value) - previous;
+    uint64_t bits = (uint64_t(delta) << 1) ^ uint64_t(delta >> 63);
+    previous = value;
+    while (bits >= 0x80) {
+        *out++ = static_cast<unsigned char>(bits | 0x80);
+        bits >>= 7;
+    }
+    *out++ = static_cast<unsigned char>(bits);
+    return out;
+}
+
+// Reads one value from [in, end) into value and returns where it ends, or
+// nullptr if the bytes run out or don't make a value
+static const unsigned char* decode(const unsigned char* in,
+                                   const unsigned char* end,
+                                   IntListEncoding encoding, int& value,
+                                   int& previous)
+{
+    if (encoding == IntListEncoding::RAW) {
+        if (end - in < 4)
+            return nullptr;
+        value = int(getUint32(in));
+        return in + 4;
+    }
+
+    uint64_t bits = 0;
+    for (size_t shift = 0; shift < 7 * MAX_VARINT; shift += 7) {
+        if (in == end)
+            return nullptr;
+        unsigned char byte = *in++;
+        bits |= uint64_t(byte & 0x7f) << shift;
+        if (byte < 0x80) {
+            int64_t delta = int64_t(bits >> 1) ^ -int64_t(bits & 1);
+            int64_t next = previous + delta;
+            if (next < INT32_MIN || next > INT32_MAX)
+                return nullptr;
+            value = previous = int(next);
+            return in;
+        }
+    }
+    return nullptr;
+}
+
+// --------------------------------------
+// Implementation of IntListWriter
+// --------------------------------------
+
+IntListWriter::IntListWriter(ostream& out, IntListEncoding encoding)
+    : IntListWriter{out, encoding, 0}
+{
+    countKnown_ = false;
+}
+
+IntListWriter::IntListWriter(ostream& out, IntListEncoding encoding,
+                             uint64_t count)
+    : out_{out}, headerAt_{out.tellp()}, encoding_{encoding},
+      countKnown_{true}, finished_{false}, expected_{count}, count_{0},
+      previous_{0}, buffer_{new unsigned char[BUFFER_SIZE]},
+      used_{HEADER_SIZE}
+{
+    // The header goes out with the first values; finish() may redo it
+    putHeader(buffer_.get(), encoding, count);
+}
+
+IntListWriter::~IntListWriter()
+{
+    finish();
+}
+
+void IntListWriter::write(int value)
+{
+    assert(!finished_);
+    if (BUFFER_SIZE - used_ < MAX_ENCODED)
+        flush();
+    used_ = size_t(encode(buffer_.get() + used_, encoding_, value, previous_)
+                   - buffer_.get());
+    ++count_;
+}
+
+void IntListWriter::flush()
+{
+    out_.write(reinterpret_cast<const char*>(buffer_.get()),
+               streamsize(used_));
+    used_ = 0;
+}
+
+bool IntListWriter::finish()
+{
+    if (finished_)
+        return bool(out_);
+    finished_ = true;
+
+    if (countKnown_) {
+        flush();
+        if (count_ != expected_)
+            out_.setstate(ios::failbit);
+        return bool(out_);
+    }
+
+    // Still buffered: fix the header in place and skip the seek
+    if (count_ * MAX_ENCODED + HEADER_SIZE <= BUFFER_SIZE) {
+        putHeader(buffer_.get(), encoding_, count_);
+        flush();
+        return bool(out_);
+    }
+
+    flush();
+    if (headerAt_ == streampos(-1)) {
+        // Nowhere to go back to
+        out_.setstate(ios::failbit);
+        return false;
+    }
+    unsigned char header[HEADER_SIZE];
+    putHeader(header, encoding_, count_);
+    streampos end = out_.tellp();
+    out_.seekp(headerAt_);
+    out_.write(reinterpret_cast<const char*>(header), HEADER_SIZE);
+    out_.seekp(end);
+    return bool(out_);
+}
+
+uint64_t IntListWriter::size() const
+{
+    return count_;
+}
+
+// --------------------------------------
+// Implementation of IntListReader
+// --------------------------------------
+
+IntListReader::IntListReader(istream& in)
+    : in_{in}, encoding_{IntListEncoding::RAW}, size_{0}, remaining_{0},
+      previous_{0}, buffer_{new unsigned char[BUFFER_SIZE]}, next_{0},
+      end_{0}
+{
+    unsigned char header[HEADER_SIZE];
+    in_.read(reinterpret_cast<char*>(header), HEADER_SIZE);
+    if (in_.gcount() != streamsize(HEADER_SIZE)
+        || !getHeader(header, encoding_, size_)) {
+        fail();
+        return;
+    }
+    remaining_ = size_;
+}
+
+bool IntListReader::refill()
+{
+    // Keep the partial value at the end of the buffer, if any
+    size_t left = end_ - next_;
+    memmove(buffer_.get(), buffer_.get() + next_, left);
+    next_ = 0;
+    end_ = left;
+
+    // Never read past the list: ask only for bytes its remaining values
+    // are sure to take. RAW values take 4 each; varints at least 1, and
+    // each complete one already buffered ends with a byte below 0x80.
+    size_t wanted = BUFFER_SIZE - end_;
+    if (remaining_ < wanted) {
+        uint64_t owed;
+        if (encoding_ == IntListEncoding::RAW) {
+            owed = 4 * remaining_ - left;
+        } else {
+            size_t complete = size_t(count_if(
+                buffer_.get(), buffer_.get() + left,
+                [](unsigned char byte) { return byte < 0x80; }));
+            owed = remaining_ - complete;
+        }
+        wanted = size_t(min<uint64_t>(wanted, owed));
+    }
+
+    in_.read(reinterpret_cast<char*>(buffer_.get() + end_),
+             streamsize(wanted));
+    end_ += size_t(in_.gcount());
+    // Running out of file part way through the buffer is expected
+    if (in_.eof())
+        in_.clear(ios::eofbit);
+    return end_ > left;
+}
+
+void IntListReader::fail()
+{
+    remaining_ = 0;
+    in_.setstate(ios::failbit);
+}
+
+bool IntListReader::read(int& value)
+{
+    if (remaining_ == 0)
+        return false;
+    if (end_ - next_ < MAX_ENCODED)
+        refill();
+
+    const unsigned char* here = buffer_.get() + next_;
+    const unsigned char* after =
+        decode(here, buffer_.get() + end_, encoding_, value, previous_);
+    if (after == nullptr) {
+        fail();
+        return false;
+    }
+    next_ += size_t(after - here);
+    --remaining_;
+    return true;
+}
+
+size_t IntListReader::read(int* values, size_t n)
+{
+    size_t count = 0;
+    while (count < n && read(values[count]))
+        ++count;
+    return count;
+}
+
+uint64_t IntListReader::size() const
+{
+    return size_;
+}
+
+uint64_t IntListReader::remaining() const
+{
+    return remaining_;
+}
+
+IntListEncoding IntListReader::encoding() const
+{
+    return encoding_;
+}
+
+IntListReader::operator bool() const
+{
+    return bool(in_);
+}
+
+// --------------------------------------
+// save() and load()
+// --------------------------------------
+
+bool save(const IntList& list, ostream& out, IntListEncoding encoding)
+{
+    // We know the count, so the stream needn't be seekable
+    IntListWriter writer{out, encoding, list.size()};
+    for (int value : list)
+        writer.write(value);
+    return writer.finish();
+}
+
+// Bytes from the read position to the end of in, or 0 if in can't seek
+static uint64_t bytesLeft(istream& in)
+{
+    streampos here = in.tellg();
+    if (here == streampos(-1))
+        return 0;
+    in.seekg(0, ios::end);
+    streampos end = in.tellg();
+    in.seekg(here);
+    if (!in || end == streampos(-1) || end < here) {
+        in.clear();
+        return 0;
+    }
+    return uint64_t(end - here);
+}
+
+bool load(istream& in, IntList& list)
+{
+    IntListReader reader{in};
+    if (!reader)
+        return false;
+
+    // The count comes from the file, so only reserve what the rest of the
+    // stream could hold: every value takes 4 bytes raw and at least 1 as a
+    // varint. Streams that can't seek grow the list as values arrive.
+    uint64_t room = bytesLeft(in);
+    if (reader.encoding() == IntListEncoding::RAW)
+        room /= 4;
+    list.reserve(size_t(min(reader.size(), room)));
+
+    // Decode in batches small enough to stay in cache
+    int batch[1024];
+    size_t got;
+    while ((got = reader.read(batch, 1024)) > 0) {
+        for (size_t i = 0; i < got; ++i)
+            list.push_back(batch[i]);
+    }
+    return bool(reader) && reader.remaining() == 0;
+}
+
+// --------------------------------------
+// Implementation of IntListView
+// --------------------------------------
+
+IntListView::IntListView(const char* path)
+    : mapping_{nullptr}, length_{0}, size_{0},
+      encoding_{IntListEncoding::RAW}
+{
+    int fd = ::open(path, O_RDONLY);
+    if (fd < 0)
+        return;
+
+    struct stat status;
+    if (::fstat(fd, &status) == 0 && size_t(status.st_size) >= HEADER_SIZE) {
+        length_ = size_t(status.st_size);
+        void* mapping = ::mmap(nullptr, length_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapping != MAP_FAILED) {
+            mapping_ = mapping;
+            // We only ever walk forward through the file
+            ::madvise(mapping_, length_, MADV_SEQUENTIAL);
+        }
+    }
+    ::close(fd);
+    if (mapping_ == nullptr)
+        return;
+
+    uint64_t count;
+    const unsigned char* bytes = static_cast<const unsigned char*>(mapping_);
+    bool good = getHeader(bytes, encoding_, count);
+    // RAW files tell us up front whether they are complete; varints take
+    // at least a byte each, so the count can at least be bounded
+    if (good && encoding_ == IntListEncoding::RAW)
+        good = count <= (length_ - HEADER_SIZE) / 4;
+    else if (good)
+        good = count <= length_ - HEADER_SIZE;
+    if (!good) {
+        ::munmap(mapping_, length_);
+        mapping_ = nullptr;
+        return;
+    }
+    size_ = size_t(count);
+}
+
+IntListView::~IntListView()
+{
+    if (mapping_ != nullptr)
+        ::munmap(mapping_, length_);
+}
+
+bool IntListView::isOpen() const
+{
+    return mapping_ != nullptr;
+}
+
+size_t IntListView::size() const
+{
+    return size_;
+}
+
+bool IntListView::empty() const
+{
+    return size_ == 0;
+}
+
+IntListEncoding IntListView::encoding() const
+{
+    return encoding_;
+}
+
+IntListView::iterator IntListView::begin() const
+{
+    if (mapping_ == nullptr)
+        return Iterator{};
+    const unsigned char* bytes = static_cast<const unsigned char*>(mapping_);
+    return Iterator{bytes + HEADER_SIZE, bytes + length_, size_, encoding_};
+}
+
+IntListView::iterator IntListView::end() const
+{
+    // Every past-the-end iterator has no values left
+    return Iterator{};
+}
+
+// --------------------------------------
+// Implementation of IntListView::Iterator
+// --------------------------------------
+
+IntListView::Iterator::Iterator(const unsigned char* next,
+                                const unsigned char* end, size_t remaining,
+                                IntListEncoding encoding)
+    : next_{next}, end_{end}, remaining_{remaining}, value_{0},
+      encoding_{encoding}
+{
+    decode();
+}
+
+void IntListView::Iterator::decode()
+{
+    if (remaining_ == 0)
+        return;
+
+    // value_ doubles as the previous value for DELTA_VARINT
+    int previous = value_;
+    next_ = ::decode(next_, end_, encoding_, value_, previous);
+    if (next_ == nullptr)
+        remaining_ = 0;
+}
+
+IntListView::Iterator& IntListView::Iterator::operator++()
+{
+    --remaining_;
+    decode();
+    return *this;
+}
+
+IntListView::Iterator IntListView::Iterator::operator++(int)
+{
+    Iterator before = *this;
+    ++*this;
+    return before;
+}
+
+int IntListView::Iterator::operator*() const
+{
+    return value_;
+}
+
+bool IntListView::Iterator::operator==(const Iterator& rhs) const
+{
+    // Iterators over one view are at the same place iff they have the same
+    // number of values left
+    return remaining_ == rhs.remaining_;
+}
+
+bool IntListView::Iterator::operator!=(const Iterator& rhs) const
+{
+    // Idiomatic code: leverage == to implement !=
+    return !(*this == rhs);
+}
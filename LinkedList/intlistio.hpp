@@ -0,0 +1,310 @@
+/**
+ * \file intlistio.hpp
+ * \authors Rachel Lee
+ * \brief Saving IntLists to, and loading them from, a compact binary format.
+ */
+
+#ifndef INTLISTIO_HPP_INCLUDED
+#define INTLISTIO_HPP_INCLUDED 1
+
+#include "intlist.hpp"
+
+#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
+
+/**
+ * \brief How the values of a saved list are laid out after its header.
+ *
+ * \details Every file starts with a 16-byte header: the bytes "ILST", a
+ *          format version, the encoding, two reserved bytes and the number
+ *          of values as a little-endian 64-bit integer.
+ */
+enum class IntListEncoding : std::uint8_t {
+    /// Each value as 4 little-endian bytes
+    RAW = 0,
+
+    /// Each value as the zigzag-encoded difference from the one before it
+    /// (the first from 0), in 7-bit groups with a continuation bit. Any
+    /// list can be saved this way, but it only pays off for sorted or
+    /// slowly-changing lists, where most values take a byte or two.
+    DELTA_VARINT = 1
+};
+
+/**
+ * \class IntListWriter
+ *
+ * \brief Writes values to a stream one at a time, in a small fixed buffer,
+ *        so the whole list never has to be in memory.
+ *
+ * \details The header's count is filled in by finish(), which seeks back
+ *          to it, unless the count was given up front; only then may the
+ *          stream be unseekable. Errors are reported through the stream's
+ *          state.
+ */
+class IntListWriter {
+public:
+    /**
+     * \brief Writes a header for a list of as yet unknown length.
+     */
+    IntListWriter(std::ostream& out, IntListEncoding encoding);
+
+    /**
+     * \brief Writes a header for a list of exactly count values.
+     */
+    IntListWriter(std::ostream& out, IntListEncoding encoding,
+                  std::uint64_t count);
+
+    /**
+     * \brief Disabled copy constructor and assignment operator.
+     */
+    IntListWriter(const IntListWriter&) = delete;
+    IntListWriter& operator=(const IntListWriter&) = delete;
+
+    /**
+     * \brief The destructor for the IntListWriter; calls finish().
+     */
+    ~IntListWriter();
+
+    /**
+     * \brief Appends a value.
+     */
+    void write(int value);
+
+    /**
+     * \brief Flushes what is buffered and completes the header.
+     * \returns Whether everything reached the stream intact.
+     */
+    bool finish();
+
+    /**
+     * \brief Returns the number of values written so far.
+     */
+    std::uint64_t size() const;
+
+private:
+    /// Bytes buffered before they are handed to the stream
+    static constexpr size_t BUFFER_SIZE = 1 << 16;
+
+    void flush();
+
+    std::ostream& out_;
+    std::streampos headerAt_;
+    IntListEncoding encoding_;
+    bool countKnown_;
+    bool finished_;
+    std::uint64_t expected_;
+    std::uint64_t count_;
+    int previous_;
+    std::unique_ptr<unsigned char[]> buffer_;
+    size_t used_;
+};
+
+/**
+ * \class IntListReader
+ *
+ * \brief Reads the values written by an IntListWriter back from a stream,
+ *        in a small fixed buffer.
+ *
+ * \details A bad header or a truncated or corrupt body sets the stream's
+ *          failbit and ends the values early. Only the list's own bytes
+ *          are taken from the stream, so whatever follows it is left to
+ *          be read.
+ */
+class IntListReader {
+public:
+    /**
+     * \brief Reads the header from in.
+     */
+    explicit IntListReader(std::istream& in);
+
+    /**
+     * \brief Disabled copy constructor and assignment operator.
+     */
+    IntListReader(const IntListReader&) = delete;
+    IntListReader& operator=(const IntListReader&) = delete;
+
+    /**
+     * \brief Reads the next value into value.
+     * \returns false, leaving value alone, if there are no more values.
+     */
+    bool read(int& value);
+
+    /**
+     * \brief Reads up to n values into values.
+     * \returns How many were read; fewer than n only at the end.
+     */
+    size_t read(int* values, size_t n);
+
+    /**
+     * \brief Returns how many values the stream holds in total.
+     */
+    std::uint64_t size() const;
+
+    /**
+     * \brief Returns how many values are left to read.
+     */
+    std::uint64_t remaining() const;
+
+    /**
+     * \brief Returns how the values are encoded.
+     */
+    IntListEncoding encoding() const;
+
+    /**
+     * \brief Returns false if the header or the stream was bad.
+     */
+    explicit operator bool() const;
+
+private:
+    /// Bytes requested from the stream at a time
+    static constexpr size_t BUFFER_SIZE = 1 << 16;
+
+    bool refill();
+    void fail();
+
+    std::istream& in_;
+    IntListEncoding encoding_;
+    std::uint64_t size_;
+    std::uint64_t remaining_;
+    int previous_;
+    std::unique_ptr<unsigned char[]> buffer_;
+    size_t next_;
+    size_t end_;
+};
+
+/**
+ * \brief Writes list to out in the given encoding.
+ * \returns Whether it was written intact.
+ */
+bool save(const IntList& list, std::ostream& out,
+          IntListEncoding encoding = IntListEncoding::RAW);
+
+/**
+ * \brief Appends the values saved in in to list.
+ *
+ * \details Reserves room for all of them first, so the list allocates at
+ *          most once.
+ * \returns Whether every value was read.
+ */
+bool load(std::istream& in, IntList& list);
+
+/**
+ * \class IntListView
+ *
+ * \brief A read-only view of a saved list, iterated straight out of the
+ *        memory-mapped file.
+ *
+ * \details Nothing is copied: RAW values are read in place, and
+ *          DELTA_VARINT values are decoded as the iterator moves. Since
+ *          each value is decoded into the iterator, the iterators are
+ *          input iterators whose operator*() returns the value rather than
+ *          a reference. A corrupt body ends the values early rather than
+ *          reading past the file.
+ */
+class IntListView {
+
+private:
+    // Forward declaration of private class.
+    class Iterator;
+
+public:
+    /**
+     * \brief Maps the file at path; check isOpen() afterwards.
+     */
+    explicit IntListView(const char* path);
+
+    /**
+     * \brief Disabled copy constructor and assignment operator.
+     */
+    IntListView(const IntListView&) = delete;
+    IntListView& operator=(const IntListView&) = delete;
+
+    /**
+     * \brief The destructor for the IntListView; unmaps the file.
+     */
+    ~IntListView();
+
+    /**
+     * \brief Returns whether the file was mapped and its header is good.
+     */
+    bool isOpen() const;
+
+    /**
+     * \brief Returns the number of values in the file.
+     */
+    size_t size() const;
+
+    /**
+     * \brief Returns whether there are no values in the file.
+     */
+    bool empty() const;
+
+    /**
+     * \brief Returns how the values are encoded.
+     */
+    IntListEncoding encoding() const;
+
+    // Allow clients to iterate over the contents of the file.
+    using iterator = Iterator;
+
+    /**
+     * \brief Returns an iterator to the first value.
+     */
+    iterator begin() const;
+
+    /**
+     * \brief Returns a past-the-end iterator.
+     */
+    iterator end() const;
+
+private:
+    class Iterator {
+    public:
+        // Definitions that are required for this class to be a well-behaved
+        // STL-style iterator that moves forward through the values. The
+        // value lives in the iterator, so it is handed out by value.
+        using value_type = int;
+        using reference = int;
+        using pointer = void;
+        using difference_type = ptrdiff_t;
+        using iterator_category = std::input_iterator_tag;
+
+        /**
+         * \brief Default constructors, assignment operators, and destructor.
+         */
+        Iterator() = default;
+        Iterator(const Iterator&) = default;
+        Iterator& operator=(const Iterator&) = default;
+        ~Iterator() = default;
+
+        Iterator& operator++();
+        Iterator operator++(int);
+        int operator*() const;
+        bool operator==(const Iterator& rhs) const;
+        bool operator!=(const Iterator& rhs) const;
+
+    private:
+        friend class IntListView;
+
+        // Decodes the value at next_, or stops if there is none
+        Iterator(const unsigned char* next, const unsigned char* end,
+                 size_t remaining, IntListEncoding encoding);
+        void decode();
+
+        const unsigned char* next_ = nullptr;
+        const unsigned char* end_ = nullptr;
+        size_t remaining_ = 0;
+        int value_ = 0;
+        IntListEncoding encoding_ = IntListEncoding::RAW;
+    };
+
+    void* mapping_;
+    size_t length_;
+    size_t size_;
+    IntListEncoding encoding_;
+};
+
+#endif // INTLISTIO_HPP_INCLUDED
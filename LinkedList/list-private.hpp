@@ -0,0 +1,940 @@
+/**
+ * \file list-private.hpp
+ * \authors Rachel Lee
+ * \brief Implements List<T, Allocator>, a linked list class template, and
+ *        its private classes.
+ *
+ * \remark There is no include-guard for this file, because it is
+ *         only #included by list.hpp, inside list.hpp's own include guard.
+ */
+
+#include <cassert>
+#include <new>
+#include <stdexcept>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../Instrumentation/probes.hpp"
+
+template <class T, class Allocator>
+List<T, Allocator>::List() : List{Allocation::OWN_SLABS} {
+}
+
+template <class T, class Allocator>
+List<T, Allocator>::List(const Allocator& alloc) :
+    List{Allocation::OWN_SLABS, alloc} {
+}
+
+template <class T, class Allocator>
+List<T, Allocator>::List(Allocation allocation, const Allocator& alloc) :
+    back_{nullptr}, front_{nullptr}, size_{0}, ownPool_{alloc},
+    allocation_{allocation} {
+}
+
+template <class T, class Allocator>
+template <class InputIterator>
+List<T, Allocator>::List(InputIterator first, InputIterator last,
+                         const Allocator& alloc) :
+    List{alloc} {
+    assign(first, last);
+}
+
+template <class T, class Allocator>
+List<T, Allocator>::List(const List& orig) :
+    List{orig.allocation_,
+         std::allocator_traits<Allocator>::
+             select_on_container_copy_construction(orig.get_allocator())} {
+    // Get every Element we need in one go
+    pool().reserve(orig.size_);
+    // Iterate over the given list and copy the values
+    // This works because push_back makes a copy instead of using a reference
+    for (iterator b = orig.begin(); b != orig.end(); ++b)  {
+        push_back(*b);
+    }
+}
+
+template <class T, class Allocator>
+List<T, Allocator>::List(List&& orig) noexcept :
+    back_{orig.back_}, front_{orig.front_}, size_{orig.size_},
+    ownPool_{orig.get_allocator()}, allocation_{orig.allocation_} {
+    // Take orig's slabs along with its Elements
+    ownPool_.swap(orig.ownPool_);
+    orig.back_ = orig.front_ = nullptr;
+    orig.size_ = 0;
+}
+
+template <class T, class Allocator>
+List<T, Allocator>::~List()
+{
+    if (empty())
+        return;
+
+    // Our own slabs are freed by ownPool_'s destructor, so only a shared
+    // pool needs the Elements back; the whole chain goes in one step
+    destroyValues(front_, back_);
+    if (allocation_ == Allocation::THREAD_POOL)
+        threadPool().recycle(front_, back_);
+}
+
+template <class T, class Allocator>
+void List<T, Allocator>::swap(List& rhs) noexcept
+{
+    using std::swap;
+
+    swap(back_, rhs.back_);
+    swap(front_, rhs.front_);
+    swap(size_, rhs.size_);
+    swap(allocation_, rhs.allocation_);
+    ownPool_.swap(rhs.ownPool_);
+}
+
+
+template <class T, class Allocator>
+void swap(List<T, Allocator>& lhs, List<T, Allocator>& rhs) noexcept
+{
+    lhs.swap(rhs);
+}
+
+
+template <class T, class Allocator>
+List<T, Allocator>& List<T, Allocator>::operator=(const List& rhs)
+{
+    // assign() reuses our Elements in place
+    if (this != &rhs)
+        assign(rhs.begin(), rhs.end());
+    return *this;
+}
+
+
+template <class T, class Allocator>
+List<T, Allocator>& List<T, Allocator>::operator=(List&& rhs) noexcept(
+    std::allocator_traits<Allocator>::is_always_equal::value)
+{
+    // Like the move constructor, we take rhs's Allocation along with its
+    // Elements, so only unequal allocators force a copy
+    if (get_allocator() == rhs.get_allocator()) {
+        // Our old contents leave with rhs
+        swap(rhs);
+    } else {
+        assign(std::make_move_iterator(rhs.begin()),
+               std::make_move_iterator(rhs.end()));
+    }
+    return *this;
+}
+
+
+template <class T, class Allocator>
+size_t List<T, Allocator>::size() const
+{
+    return size_;
+}
+
+template <class T, class Allocator>
+bool List<T, Allocator>::empty() const
+{
+    return size_ == 0;
+}
+
+
+template <class T, class Allocator>
+void List<T, Allocator>::reserve(size_t n)
+{
+    pool().reserve(n);
+}
+
+
+template <class T, class Allocator>
+typename List<T, Allocator>::Allocation List<T, Allocator>::allocation() const
+{
+    return allocation_;
+}
+
+
+template <class T, class Allocator>
+Allocator List<T, Allocator>::get_allocator() const
+{
+    return ownPool_.allocator();
+}
+
+
+template <class T, class Allocator>
+typename List<T, Allocator>::Pool& List<T, Allocator>::pool()
+{
+    return allocation_ == Allocation::THREAD_POOL ? threadPool() : ownPool_;
+}
+
+
+template <class T, class Allocator>
+typename List<T, Allocator>::Pool& List<T, Allocator>::threadPool()
+{
+    static thread_local Pool shared;
+    return shared;
+}
+
+
+template <class T, class Allocator>
+template <class... Args>
+typename List<T, Allocator>::Element*
+List<T, Allocator>::make(Element* next, Args&&... args)
+{
+    Element* slot = pool().take();
+    try {
+        ::new (static_cast<void*>(slot->storage_))
+            T(std::forward<Args>(args)...);
+    } catch (...) {
+        pool().recycle(slot);
+        throw;
+    }
+    slot->next_ = next;
+    return slot;
+}
+
+
+template <class T, class Allocator>
+void List<T, Allocator>::destroyValues(Element* first, Element* last)
+{
+    // Nothing to do for ints and the like, which keeps teardown O(slabs)
+    if constexpr (!std::is_trivially_destructible<T>::value) {
+        for (Element* here = first; ; here = here->next_) {
+            here->value().~T();
+            if (here == last)
+                break;
+        }
+    }
+}
+
+
+template <class T, class Allocator>
+bool List<T, Allocator>::operator==(const List& rhs) const
+{
+    return equals(rhs);
+}
+
+template <class T, class Allocator>
+bool List<T, Allocator>::operator!=(const List& rhs) const
+{
+    // Idiomatic code: leverage == to implement !=
+    return !operator==(rhs);
+}
+
+
+template <class T, class Allocator>
+typename List<T, Allocator>::sum_type List<T, Allocator>::sum() const
+{
+    // Elements are not contiguous, so there is nothing to vectorize; walking
+    // the Elements directly at least spares us the iterator
+    sum_type sum{};
+    for (const Element* here = empty() ? nullptr : front_; here != nullptr;
+         here = here->next_)
+        sum += here->value();
+    return sum;
+}
+
+
+template <class T, class Allocator>
+size_t List<T, Allocator>::count(const T& value) const
+{
+    size_t count = 0;
+    for (const Element* here = empty() ? nullptr : front_; here != nullptr;
+         here = here->next_)
+        count += size_t(here->value() == value);
+    return count;
+}
+
+
+template <class T, class Allocator>
+typename List<T, Allocator>::iterator List<T, Allocator>::find(const T& value) const
+{
+    DATASTRUCTURES_PROBE("List::find");
+    Element* here = empty() ? nullptr : front_;
+    while (here != nullptr && !(here->value() == value))
+        here = here->next_;
+    return Iterator{here};
+}
+
+
+template <class T, class Allocator>
+bool List<T, Allocator>::equals(const List& rhs) const
+{
+    // Cheap check
+    if (size_ != rhs.size_)
+        return false;
+    
+    // Have to compare element by element otherwise, bailing early as soon
+    // as we find a difference
+    const Element* a = empty() ? nullptr : front_;
+    const Element* b = rhs.empty() ? nullptr : rhs.front_;
+    for (; a != nullptr; a = a->next_, b = b->next_) {
+        if (!(a->value() == b->value()))
+            return false;
+    }
+    return true;
+}
+
+
+template <class T, class Allocator>
+bool List<T, Allocator>::consistent() const
+{
+    // front_ and back_ are stale once the list is empty
+    if (empty())
+        return true;
+
+    const Element* here = front_;
+    for (size_t i = 1; i < size_; ++i) {
+        here = here->next_;
+        if (here == nullptr)
+            return false;
+    }
+    return here == back_ && back_->next_ == nullptr;
+}
+
+
+template <class T, class Allocator>
+void List<T, Allocator>::push_front(const T& pushee)
+{
+    emplace_front(pushee);
+}
+
+
+template <class T, class Allocator>
+void List<T, Allocator>::push_front(T&& pushee)
+{
+    emplace_front(std::move(pushee));
+}
+
+
+template <class T, class Allocator>
+template <class... Args>
+T& List<T, Allocator>::emplace_front(Args&&... args)
+{
+    DATASTRUCTURES_PROBE("List::push_front");
+    // Create a new Element that has the current front_ as its next_, then
+    // repoint front_ to our new Element
+    front_ = make(empty() ? nullptr : front_, std::forward<Args>(args)...);
+    ++size_;
+
+    // Handle the edge case where we push onto an empty list
+    if (size_ == 1)
+        back_ = front_;
+    return front_->value();
+}
+
+
+template <class T, class Allocator>
+T List<T, Allocator>::pop_front()
+{
+    DATASTRUCTURES_PROBE("List::pop_front");
+    assert(!empty());
+
+    // Get our value before we recycle the Element
+    T value = std::move(front_->value());
+
+    // Repoint everything as necessary
+    Element* first = front_;
+    front_ = first->next_;
+    --size_;
+    first->value().~T();
+    pool().recycle(first);
+    return value;
+}
+
+
+template <class T, class Allocator>
+void List<T, Allocator>::push_back(const T& pushee)
+{
+    emplace_back(pushee);
+}
+
+
+template <class T, class Allocator>
+void List<T, Allocator>::push_back(T&& pushee)
+{
+    emplace_back(std::move(pushee));
+}
+
+
+template <class T, class Allocator>
+template <class... Args>
+T& List<T, Allocator>::emplace_back(Args&&... args)
+{
+    DATASTRUCTURES_PROBE("List::push_back");
+    // The new Element is the last node in the list, it doesn't need a next_
+    Element* last = make(nullptr, std::forward<Args>(args)...);
+    // Our more common case, a non-empty list
+    if (!empty()) {
+        back_->next_ = last;
+    } else { // The edge case of an empty list
+        front_ = last;
+    }
+    back_ = last;
+    ++size_;
+    return last->value();
+}
+
+
+template <class T, class Allocator>
+void List<T, Allocator>::insert_after(iterator where, const T& value)
+{
+    emplace_after(where, value);
+}
+
+
+template <class T, class Allocator>
+template <class... Args>
+typename List<T, Allocator>::iterator
+List<T, Allocator>::emplace_after(iterator where, Args&&... args)
+{
+    DATASTRUCTURES_PROBE("List::insert_after");
+    // Make a new Element and point it to the next value
+    Element* inserted = make(where.current_->next_, std::forward<Args>(args)...);
+    // Repoint the current Element to the new element
+    where.current_->next_ = inserted;
+    // Inserting after the last Element gives us a new tail
+    if (back_ == where.current_)
+        back_ = inserted;
+    ++size_;
+    return Iterator{inserted};
+}
+
+
+template <class T, class Allocator>
+template <class InputIterator>
+void List<T, Allocator>::reserveFor(InputIterator first, InputIterator last,
+                                    size_t have)
+{
+    using category =
+        typename std::iterator_traits<InputIterator>::iterator_category;
+
+    // Counting an input range would consume it
+    if constexpr (std::is_base_of<std::forward_iterator_tag, category>::value) {
+        size_t wanted = size_t(std::distance(first, last));
+        if (wanted > have)
+            pool().reserve(wanted - have);
+    }
+}
+
+
+template <class T, class Allocator>
+template <class InputIterator>
+void List<T, Allocator>::insert_after(iterator where, InputIterator first,
+                                      InputIterator last)
+{
+    if (first == last)
+        return;
+
+    reserveFor(first, last, 0);
+
+    // Build the new values into a chain of their own, then link it in
+    Element* chainFront = make(nullptr, *first);
+    Element* chainBack = chainFront;
+    size_t count = 1;
+    for (++first; first != last; ++first) {
+        chainBack->next_ = make(nullptr, *first);
+        chainBack = chainBack->next_;
+        ++count;
+    }
+    spliceChain(where.current_, chainFront, chainBack, count);
+}
+
+
+template <class T, class Allocator>
+template <class InputIterator>
+void List<T, Allocator>::assign(InputIterator first, InputIterator last)
+{
+    reserveFor(first, last, size_);
+
+    // Overwrite as many of our Elements as there are values
+    Element* kept = nullptr;
+    Element* here = empty() ? nullptr : front_;
+    size_t overwritten = 0;
+    for (; here != nullptr && first != last; ++first) {
+        here->value() = *first;
+        kept = here;
+        here = here->next_;
+        ++overwritten;
+    }
+
+    if (here != nullptr) {
+        // Hand back the Elements we no longer need
+        destroyValues(here, back_);
+        pool().recycle(here, back_);
+        if (kept != nullptr)
+            kept->next_ = nullptr;
+        else
+            front_ = nullptr;
+        back_ = kept;
+        size_ = overwritten;
+    } else {
+        for (; first != last; ++first)
+            push_back(*first);
+    }
+}
+
+
+template <class T, class Allocator>
+void List<T, Allocator>::spliceChain(Element* after, Element* first,
+                                     Element* last, size_t count)
+{
+    if (after == nullptr) {
+        last->next_ = empty() ? nullptr : front_;
+        front_ = first;
+    } else {
+        last->next_ = after->next_;
+        after->next_ = first;
+    }
+
+    // A chain at the very end (or in an empty list) gives us a new tail
+    if (empty() || after == back_)
+        back_ = last;
+    size_ += count;
+}
+
+
+template <class T, class Allocator>
+bool List<T, Allocator>::adoptElementsOf(List& other)
+{
+    if (allocation_ != other.allocation_)
+        return false;
+
+    // Shared pools already agree; private slabs have to change hands
+    if (allocation_ == Allocation::OWN_SLABS) {
+        if (!(get_allocator() == other.get_allocator()))
+            return false;
+        ownPool_.adopt(other.ownPool_);
+    }
+    return true;
+}
+
+
+template <class T, class Allocator>
+void List<T, Allocator>::splice_after(iterator where, List& other)
+{
+    if (&other == this || other.empty())
+        return;
+
+    if (adoptElementsOf(other)) {
+        spliceChain(where.current_, other.front_, other.back_, other.size_);
+        other.back_ = other.front_ = nullptr;
+        other.size_ = 0;
+    } else {
+        insert_after(where, std::make_move_iterator(other.begin()),
+                     std::make_move_iterator(other.end()));
+        List emptied{std::move(other)};
+    }
+}
+
+
+template <class T, class Allocator>
+void List<T, Allocator>::append(List&& other)
+{
+    if (&other == this || other.empty())
+        return;
+
+    if (adoptElementsOf(other)) {
+        spliceChain(empty() ? nullptr : back_, other.front_, other.back_,
+                    other.size_);
+        other.back_ = other.front_ = nullptr;
+        other.size_ = 0;
+    } else {
+        reserveFor(other.begin(), other.end(), 0);
+        for (iterator b = other.begin(); b != other.end(); ++b)
+            push_back(std::move(*b));
+        List emptied{std::move(other)};
+    }
+}
+
+
+template <class T, class Allocator>
+typename List<T, Allocator>::Element*
+List<T, Allocator>::mergeChains(Element* a, Element* b, Element*& tail)
+{
+    // Link onto a placeholder head so the first Element isn't a special case
+    Element* head = nullptr;
+    Element** link = &head;
+    tail = nullptr;
+
+    while (a != nullptr && b != nullptr) {
+        if (b->value() < a->value()) {
+            *link = b;
+            b = b->next_;
+        } else {
+            *link = a;
+            a = a->next_;
+        }
+        tail = *link;
+        link = &tail->next_;
+    }
+
+    // Whatever is left is already sorted; find its end for the caller
+    *link = a != nullptr ? a : b;
+    while (*link != nullptr) {
+        tail = *link;
+        link = &tail->next_;
+    }
+    return head;
+}
+
+
+template <class T, class Allocator>
+typename List<T, Allocator>::Element*
+List<T, Allocator>::sortChain(Element* head, Element*& tail)
+{
+    // bins[i] is empty or a sorted chain of exactly 2^i Elements, so 64
+    // bins are enough for any list that fits in memory
+    Element* bins[64] = {};
+    Element* ignored;
+
+    while (head != nullptr) {
+        Element* carry = head;
+        head = head->next_;
+        carry->next_ = nullptr;
+
+        // Like binary addition: merge equal-sized runs until a bin is free
+        size_t i = 0;
+        for (; bins[i] != nullptr; ++i) {
+            carry = mergeChains(bins[i], carry, ignored);
+            bins[i] = nullptr;
+        }
+        bins[i] = carry;
+    }
+
+    // Combine the bins, older (earlier) Elements first to stay stable
+    Element* sorted = nullptr;
+    tail = nullptr;
+    for (Element* bin : bins) {
+        if (bin != nullptr)
+            sorted = mergeChains(bin, sorted, tail);
+    }
+    return sorted;
+}
+
+
+template <class T, class Allocator>
+void List<T, Allocator>::sort()
+{
+    DATASTRUCTURES_PROBE("List::sort");
+    if (size_ < 2)
+        return;
+    front_ = sortChain(front_, back_);
+}
+
+
+template <class T, class Allocator>
+void List<T, Allocator>::parallel_sort(size_t threads)
+{
+    // Small pieces are not worth a thread of their own
+    const size_t MIN_PIECE = 4096;
+    if (threads > size_ / MIN_PIECE)
+        threads = size_ / MIN_PIECE;
+    if (threads < 2) {
+        sort();
+        return;
+    }
+
+    // Cut the list into threads contiguous, null-terminated pieces
+    std::vector<Element*> heads(threads);
+    std::vector<Element*> tails(threads);
+    Element* here = front_;
+    for (size_t t = 0; t < threads; ++t) {
+        size_t length = size_ / threads + (t < size_ % threads ? 1 : 0);
+        heads[t] = here;
+        for (size_t i = 1; i < length; ++i)
+            here = here->next_;
+        Element* next = here->next_;
+        here->next_ = nullptr;
+        here = next;
+    }
+
+    std::vector<std::thread> workers;
+    for (size_t t = 1; t < threads; ++t) {
+        workers.emplace_back([&heads, &tails, t] {
+            heads[t] = sortChain(heads[t], tails[t]);
+        });
+    }
+    heads[0] = sortChain(heads[0], tails[0]);
+    for (std::thread& worker : workers)
+        worker.join();
+
+    // Merge neighbouring pieces pairwise, halving their number each round
+    for (size_t step = 1; step < threads; step *= 2) {
+        for (size_t t = 0; t + step < threads; t += 2 * step)
+            heads[t] = mergeChains(heads[t], heads[t + step], tails[t]);
+    }
+    front_ = heads[0];
+    back_ = tails[0];
+}
+
+
+template <class T, class Allocator>
+void List<T, Allocator>::merge(List&& other)
+{
+    if (&other == this || other.empty())
+        return;
+
+    if (!adoptElementsOf(other)) {
+        // Copy other's values into Elements we are able to relink
+        List converted{allocation_, get_allocator()};
+        converted.assign(std::make_move_iterator(other.begin()),
+                         std::make_move_iterator(other.end()));
+        List emptied{std::move(other)};
+        merge(std::move(converted));
+        return;
+    }
+
+    if (empty()) {
+        front_ = other.front_;
+        back_ = other.back_;
+    } else {
+        front_ = mergeChains(front_, other.front_, back_);
+    }
+    size_ += other.size_;
+    other.back_ = other.front_ = nullptr;
+    other.size_ = 0;
+}
+
+
+template <class T, class Allocator>
+typename List<T, Allocator>::iterator List<T, Allocator>::begin() const
+{
+    // Iterator to the first element
+    return Iterator{empty() ? nullptr : front_};
+}
+
+
+template <class T, class Allocator>
+typename List<T, Allocator>::iterator List<T, Allocator>::end() const
+{
+    // Iterator to an invalid element; if we have an iterator whose current_
+    // value is this then we've gone past the end of the list
+    return Iterator{nullptr};
+}
+
+// --------------------------------------
+// Implementation of List::Element
+// --------------------------------------
+
+template <class T, class Allocator>
+T& List<T, Allocator>::Element::value()
+{
+    return *std::launder(reinterpret_cast<T*>(storage_));
+}
+
+
+template <class T, class Allocator>
+const T& List<T, Allocator>::Element::value() const
+{
+    return *std::launder(reinterpret_cast<const T*>(storage_));
+}
+
+// --------------------------------------
+// Implementation of List::Slab
+// --------------------------------------
+
+template <class T, class Allocator>
+typename List<T, Allocator>::Element* List<T, Allocator>::Slab::elements()
+{
+    // The Elements start right after the header
+    return reinterpret_cast<Element*>(reinterpret_cast<SlabUnit*>(this)
+                                      + SLAB_HEADER_UNITS);
+}
+
+// --------------------------------------
+// Implementation of List::Pool
+// --------------------------------------
+
+template <class T, class Allocator>
+List<T, Allocator>::Pool::Pool(const Allocator& alloc) noexcept
+    : units_{alloc}, free_{nullptr}, unused_{nullptr}, slabEnd_{nullptr},
+      slabs_{nullptr}, nextSlab_{FIRST_SLAB}
+{
+    // Nothing else to do
+}
+
+
+template <class T, class Allocator>
+List<T, Allocator>::Pool::~Pool()
+{
+    release();
+}
+
+
+template <class T, class Allocator>
+typename List<T, Allocator>::Element* List<T, Allocator>::Pool::take()
+{
+    if (free_ != nullptr) {
+        Element* slot = free_;
+        free_ = free_->next_;
+        return slot;
+    }
+
+    if (unused_ == slabEnd_)
+        grow(nextSlab_);
+    return ::new (static_cast<void*>(unused_++)) Element;
+}
+
+
+template <class T, class Allocator>
+void List<T, Allocator>::Pool::recycle(Element* garbage)
+{
+    garbage->next_ = free_;
+    free_ = garbage;
+}
+
+
+template <class T, class Allocator>
+void List<T, Allocator>::Pool::recycle(Element* first, Element* last)
+{
+    last->next_ = free_;
+    free_ = first;
+}
+
+
+template <class T, class Allocator>
+void List<T, Allocator>::Pool::reserve(size_t n)
+{
+    if (size_t(slabEnd_ - unused_) >= n)
+        return;
+
+    // Keep what is left of the current slab by moving it to the free list
+    while (unused_ != slabEnd_)
+        recycle(::new (static_cast<void*>(unused_++)) Element);
+    grow(n);
+}
+
+
+template <class T, class Allocator>
+void List<T, Allocator>::Pool::grow(size_t minimum)
+{
+    size_t capacity = minimum > nextSlab_ ? minimum : nextSlab_;
+    // The header shares the slab, so a huge request could wrap the sum
+    size_t most = std::allocator_traits<UnitAllocator>::max_size(units_);
+    if (most < SLAB_HEADER_UNITS || capacity > most - SLAB_HEADER_UNITS)
+        throw std::length_error("List: cannot reserve that many elements");
+    SlabUnit* memory = std::allocator_traits<UnitAllocator>::allocate(
+        units_, SLAB_HEADER_UNITS + capacity);
+    Slab* slab = ::new (static_cast<void*>(memory)) Slab{slabs_, capacity};
+    slabs_ = slab;
+
+    unused_ = slab->elements();
+    slabEnd_ = unused_ + slab->capacity_;
+    if (nextSlab_ < LARGEST_SLAB)
+        nextSlab_ *= 2;
+}
+
+
+template <class T, class Allocator>
+void List<T, Allocator>::Pool::release()
+{
+    while (slabs_ != nullptr) {
+        Slab* next = slabs_->next_;
+        std::allocator_traits<UnitAllocator>::deallocate(
+            units_, reinterpret_cast<SlabUnit*>(slabs_),
+            SLAB_HEADER_UNITS + slabs_->capacity_);
+        slabs_ = next;
+    }
+    free_ = unused_ = slabEnd_ = nullptr;
+    nextSlab_ = FIRST_SLAB;
+}
+
+
+template <class T, class Allocator>
+void List<T, Allocator>::Pool::adopt(Pool& other)
+{
+    if (other.slabs_ == nullptr)
+        return;
+
+    // Put other's slabs (newest first) behind our own
+    Slab* oldest = other.slabs_;
+    while (oldest->next_ != nullptr)
+        oldest = oldest->next_;
+    oldest->next_ = slabs_;
+    slabs_ = other.slabs_;
+
+    other.slabs_ = nullptr;
+    other.free_ = other.unused_ = other.slabEnd_ = nullptr;
+    other.nextSlab_ = FIRST_SLAB;
+}
+
+
+template <class T, class Allocator>
+Allocator List<T, Allocator>::Pool::allocator() const
+{
+    return Allocator(units_);
+}
+
+
+template <class T, class Allocator>
+void List<T, Allocator>::Pool::swap(Pool& rhs) noexcept
+{
+    using std::swap;
+
+    // Allocators that don't propagate on swap are required to be equal
+    if constexpr (std::allocator_traits<UnitAllocator>::
+                      propagate_on_container_swap::value)
+        swap(units_, rhs.units_);
+    swap(free_, rhs.free_);
+    swap(unused_, rhs.unused_);
+    swap(slabEnd_, rhs.slabEnd_);
+    swap(slabs_, rhs.slabs_);
+    swap(nextSlab_, rhs.nextSlab_);
+}
+
+// --------------------------------------
+// Implementation of List::Iterator
+// --------------------------------------
+
+template <class T, class Allocator>
+List<T, Allocator>::Iterator::Iterator(Element* current)
+    : current_{current}
+{
+    // Nothing else to do
+}
+
+
+template <class T, class Allocator>
+typename List<T, Allocator>::Iterator& List<T, Allocator>::Iterator::operator++()
+{
+    // Move the pointer along, then return a reference to the current instance
+    current_ = current_->next_;
+    return *this;
+}
+
+
+template <class T, class Allocator>
+typename List<T, Allocator>::Iterator List<T, Allocator>::Iterator::operator++(int)
+{
+    Iterator before = *this;
+    ++*this;
+    return before;
+}
+
+
+template <class T, class Allocator>
+T& List<T, Allocator>::Iterator::operator*() const
+{
+    // Return a reference to the current value
+    return current_->value();
+}
+
+
+template <class T, class Allocator>
+T* List<T, Allocator>::Iterator::operator->() const
+{
+    return &current_->value();
+}
+
+
+template <class T, class Allocator>
+bool List<T, Allocator>::Iterator::operator==(const Iterator& rhs) const
+{
+    return (rhs.current_ == current_);
+}
+
+
+template <class T, class Allocator>
+bool List<T, Allocator>::Iterator::operator!=(const Iterator& rhs) const
+{
+    // Idiomatic code: leverage == to implement !=
+    return !(*this == rhs);
+}
@@ -0,0 +1,577 @@
+/**
+ * \file list.hpp
+ * \authors Rachel Lee
+ * \brief A singly-linked list of any element type.
+ */
+
+#ifndef LIST_HPP_INCLUDED
+#define LIST_HPP_INCLUDED 1
+
+#include <iostream>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <type_traits>
+
+/**
+ * \class List
+ *
+ * \brief A linked list of many Element objects which hold \c T values.
+ *
+ * \details Class allocates memory dynamically; thus can't use C++'s
+ *          defaults for copy constructor, assignment operator and
+ *          destructor.
+ *
+ *          Each value is stored inside its Element, with no further
+ *          indirection, and the emplace functions construct it there
+ *          directly. Elements are carved out of slabs obtained from
+ *          Allocator and recycled on pop_front() rather than going back
+ *          to the allocator one at a time. By default each list owns its
+ *          slabs and frees them all in its destructor; see Allocation for
+ *          sharing one pool per thread instead.
+ */
+template <class T, class Allocator = std::allocator<T>>
+class List {
+
+private:
+    // Forward declaration of private class.
+    class Iterator;
+
+public:
+
+    using value_type = T;
+    using allocator_type = Allocator;
+
+    /// Type sum() accumulates in; wide enough for any list of small ints
+    using sum_type = typename std::conditional<
+        std::is_integral<T>::value && sizeof(T) < sizeof(long long),
+        long long, T>::type;
+
+    /**
+     * \brief Where a list gets its Elements from.
+     */
+    enum class Allocation {
+        /// Slabs owned by the list and released together by its destructor
+        OWN_SLABS,
+
+        /// A pool shared by every THREAD_POOL list of this type on the
+        /// calling thread, so Elements popped from one list are reused by
+        /// the next push to any of them. Uses a default-constructed
+        /// Allocator.
+        ///
+        /// \warning Such lists must be created, used and destroyed on one
+        ///          thread, and must not outlive it.
+        THREAD_POOL
+    };
+
+    /**
+     * \brief The default constructor for the List.
+     */
+    List();
+
+    /**
+     * \brief Constructs an empty List whose slabs come from alloc.
+     */
+    explicit List(const Allocator& alloc);
+
+    /**
+     * \brief Constructs an empty List that gets its Elements as
+     *        allocation says.
+     */
+    explicit List(Allocation allocation, const Allocator& alloc = Allocator());
+
+    /**
+     * \brief Constructs a List holding the values in [first, last).
+     *
+     * \details For forward iterators all Elements come from a single
+     *          allocation.
+     */
+    template <class InputIterator>
+    List(InputIterator first, InputIterator last,
+         const Allocator& alloc = Allocator());
+
+    /**
+     * \brief The copy constructor for the List.
+     *
+     * \details All of the copy's Elements come from a single allocation.
+     */
+    List(const List& orig);
+
+    /**
+     * \brief The move constructor for the List.
+     * \post orig is empty.
+     */
+    List(List&& orig) noexcept;
+
+    /**
+     * \brief Overloads the assignment operator for the List.
+     *
+     * \details Overwrites the Elements we already have in place, so it
+     *          only allocates if rhs is longer than this list.
+     */
+    List& operator=(const List& rhs);
+
+    /**
+     * \brief Overloads the move assignment operator for the List.
+     *
+     * \details Takes over rhs's Elements, and its Allocation, unless the
+     *          two lists' allocators differ, in which case the values are
+     *          moved one by one. Never allocates when the allocators always
+     *          compare equal.
+     */
+    List& operator=(List&& rhs) noexcept(
+        std::allocator_traits<Allocator>::is_always_equal::value);
+
+    /**
+     * \brief The destructor for the List.
+     */
+    ~List();
+
+    /**
+     * \brief Swap function for a List.
+     *
+     * \note The lists' allocators must compare equal.
+     */
+    void swap(List& rhs) noexcept;
+
+    /**
+     * \brief Pushes a value onto the front of the list
+     * \post Size increased by one, pointers adjusted appropriately.
+     */
+    void push_front(const T& pushee);   ///< Push onto head of list
+    void push_front(T&& pushee);        ///< Push onto head of list
+
+    /**
+     * \brief Constructs a value from args directly at the front of the list.
+     * \returns The new value.
+     */
+    template <class... Args>
+    T& emplace_front(Args&&... args);
+
+    /**
+     * \brief Pushes a value onto the end of the list.
+     * \post Size increased by one, pointers adjusted appropriately.
+     */
+    void push_back(const T& pushee);    ///< Push onto tail of list
+    void push_back(T&& pushee);         ///< Push onto tail of list
+
+    /**
+     * \brief Constructs a value from args directly at the end of the list.
+     * \returns The new value.
+     */
+    template <class... Args>
+    T& emplace_back(Args&&... args);
+
+    /**
+     * \brief Removes the first value from the list.
+     * \post Size decreased by one, pointers adjusted appropriately.
+     */
+    T pop_front();                      ///< Drop & return the head element
+
+    /**
+     * \brief Returns the number of values in the list.
+     */
+    size_t size() const;                ///< Size of the list
+
+    /**
+     * \brief Returns whether there are no values in the list.
+     */
+    bool empty() const;                 ///< true if the list is empty
+
+    /**
+     * \brief Makes room for n more values, so the next n pushes don't
+     *        allocate.
+     */
+    void reserve(size_t n);
+
+    /**
+     * \brief Returns where the list gets its Elements from.
+     */
+    Allocation allocation() const;
+
+    /**
+     * \brief Returns the allocator the list's own slabs come from.
+     */
+    Allocator get_allocator() const;
+
+    /**
+     * \brief Overloads the equality operator for Lists.
+     */
+    bool operator==(const List& rhs) const;
+
+    /**
+     * \brief Overloads the inequality operator for Lists.
+     */
+    bool operator!=(const List& rhs) const;
+
+    // Allow clients to iterate over the contents of the list.
+    using iterator = Iterator;
+
+    /**
+     * \brief Returns an iterator to the front of the list.
+     */
+    iterator begin() const; ///< An iterator that refers to the first element
+
+    /**
+     * \brief Returns a 'null' iterator.
+     */
+    iterator end() const;   ///< An invalid / "past-the-end" iterator
+
+    /**
+     * \brief Returns the sum of the values in the list.
+     */
+    sum_type sum() const;
+
+    /**
+     * \brief Returns how many values in the list equal value.
+     */
+    size_t count(const T& value) const;
+
+    /**
+     * \brief Returns an iterator to the first value equal to value, or
+     *        end() if there is none.
+     */
+    iterator find(const T& value) const;
+
+    /**
+     * \brief Returns whether rhs holds the same values in the same order.
+     */
+    bool equals(const List& rhs) const;
+
+    /**
+     * \brief Returns whether the links agree with size(): size() Elements
+     *        lead from the front to the back, and nothing follows the back.
+     *
+     * \details Walks the whole list, so it is meant for checks in debugging
+     *          and stress runs rather than normal use.
+     */
+    bool consistent() const;
+
+    /**
+     * Insert a value after a given iterator
+     *
+     * \details The iterator cannot be end(), the list cannot be empty.
+     */
+    void insert_after(iterator where, const T& value);
+
+    /**
+     * Construct a value from args directly after a given iterator
+     *
+     * \details The iterator cannot be end(), the list cannot be empty.
+     * \returns An iterator to the new value.
+     */
+    template <class... Args>
+    iterator emplace_after(iterator where, Args&&... args);
+
+    /**
+     * Insert the values in [first, last) after a given iterator, in order
+     *
+     * \details The iterator cannot be end(), the list cannot be empty.
+     */
+    template <class InputIterator>
+    void insert_after(iterator where, InputIterator first, InputIterator last);
+
+    /**
+     * \brief Replaces the contents of the list with the values in
+     *        [first, last).
+     *
+     * \details Overwrites the Elements we already have in place, so it
+     *          only allocates if the range is longer than the list.
+     */
+    template <class InputIterator>
+    void assign(InputIterator first, InputIterator last);
+
+    /**
+     * \brief Moves every value of other into this list, after where.
+     *
+     * \details Relinks other's Elements in O(1) if both lists use the same
+     *          Allocation (taking over other's slabs when they are
+     *          OWN_SLABS from equal allocators), and copies the values
+     *          otherwise.
+     *          The iterator cannot be end(), the list cannot be empty.
+     * \post other is empty.
+     */
+    void splice_after(iterator where, List& other);
+
+    /**
+     * \brief Moves every value of other onto the end of this list.
+     *
+     * \details Same cost as splice_after().
+     * \post other is empty.
+     */
+    void append(List&& other);
+
+    /**
+     * \brief Sorts the list into ascending order by relinking Elements.
+     *
+     * \details A stable, bottom-up merge sort; it neither recurses nor
+     *          allocates.
+     */
+    void sort();
+
+    /**
+     * \brief Sorts the list like sort(), splitting the work over up to
+     *        threads threads and merging their results.
+     */
+    void parallel_sort(size_t threads);
+
+    /**
+     * \brief Moves the values of other into this list, keeping it sorted.
+     *
+     * \details Both lists must already be sorted. Equal values from this
+     *          list stay ahead of those from other. Relinks other's Elements
+     *          on the same terms as splice_after().
+     * \post other is empty.
+     */
+    void merge(List&& other);
+
+private:
+    /***
+     * \struct Element
+     *
+     * \brief The list is stored as a linked list of Elements.
+     *        The class is private so only List knows about it.
+     *
+     * \details The value lives in raw storage inside the Element, so an
+     *          Element can sit on a free list without a live value and the
+     *          value can be constructed in place. The Copy Constructor and
+     *          Assignment operator are disabled.
+     */
+    struct Element {
+        Element* next_;
+        alignas(T) unsigned char storage_[sizeof(T)];
+
+        T& value();        ///< The value; only valid once constructed
+        const T& value() const;
+
+        Element() = default;
+        Element(const Element&) = delete;
+        Element& operator=(const Element&) = delete;
+        ~Element() = default;
+    };
+
+    /***
+     * \struct Slab
+     *
+     * \brief A block of memory holding capacity_ Elements, which follow
+     *        the header directly.
+     */
+    struct Slab {
+        Slab*  next_;      ///< Next slab owned by the same Pool
+        size_t capacity_;  ///< Number of Elements the slab holds
+
+        Element* elements();  ///< The first Element slot
+    };
+
+    /// Element-sized, Element-aligned unit in which slabs are allocated
+    struct alignas(Element) SlabUnit {
+        unsigned char bytes_[sizeof(Element)];
+    };
+
+    /// SlabUnits taken up by a Slab header
+    static constexpr size_t SLAB_HEADER_UNITS =
+        (sizeof(Slab) + sizeof(SlabUnit) - 1) / sizeof(SlabUnit);
+
+    using UnitAllocator =
+        typename std::allocator_traits<Allocator>::template rebind_alloc<SlabUnit>;
+
+    /***
+     * \class Pool
+     *
+     * \brief Hands out Element slots from slabs and keeps recycled slots
+     *        on a free list for reuse.
+     *
+     * \details Slabs double in size as the pool grows, so a pool holding n
+     *          Elements has O(log n) slabs. The pool never constructs or
+     *          destroys values; releasing it simply frees its slabs.
+     */
+    class Pool {
+    public:
+        explicit Pool(const Allocator& alloc = Allocator()) noexcept;
+        ~Pool();  ///< Frees every slab
+
+        Pool(const Pool&) = delete;
+        Pool& operator=(const Pool&) = delete;
+
+        /**
+         * \brief Returns an unused Element slot; its value is not yet
+         *        constructed.
+         */
+        Element* take();
+
+        /**
+         * \brief Makes sure the next n calls to take() do not allocate.
+         */
+        void reserve(size_t n);
+
+        /**
+         * \brief Puts one slot (whose value is destroyed) onto the free
+         *        list.
+         */
+        void recycle(Element* garbage);
+
+        /**
+         * \brief Puts the whole chain first ... last onto the free list in
+         *        O(1). Their values must already be destroyed.
+         */
+        void recycle(Element* first, Element* last);
+
+        /**
+         * \brief Frees every slab, invalidating all Elements made by the
+         *        pool.
+         */
+        void release();
+
+        /**
+         * \brief Takes ownership of all of other's slabs.
+         *
+         * \note The pools' allocators must compare equal.
+         * \post other owns nothing; Elements other had free are not reused.
+         */
+        void adopt(Pool& other);
+
+        Allocator allocator() const;  ///< The allocator slabs come from
+
+        void swap(Pool& rhs) noexcept;
+
+    private:
+        static constexpr size_t FIRST_SLAB = 16;     ///< Elements in slab 1
+        static constexpr size_t LARGEST_SLAB = 65536;
+
+        UnitAllocator units_;  ///< Where slabs come from
+        Element* free_;      ///< Recycled Elements, linked through next_
+        Element* unused_;    ///< Next never-used slot in the newest slab
+        Element* slabEnd_;   ///< One past the newest slab's last slot
+        Slab*    slabs_;     ///< Every slab, newest first
+        size_t   nextSlab_;  ///< Capacity of the next slab to allocate
+
+        /**
+         * \brief Allocates a new slab with room for at least minimum
+         *        Elements.
+         */
+        void grow(size_t minimum);
+    };
+
+    Element* back_;   ///< Current tail of list
+    Element* front_;  ///< Current head of list
+    size_t   size_;   ///< Current size of list
+
+    Pool ownPool_;        ///< Slabs used when allocation_ is OWN_SLABS
+    Allocation allocation_;
+
+    /**
+     * \brief Returns the pool this list takes Elements from.
+     */
+    Pool& pool();
+
+    /**
+     * \brief Returns the calling thread's shared pool.
+     */
+    static Pool& threadPool();
+
+    /**
+     * \brief Takes a slot from the pool and constructs its value from args.
+     */
+    template <class... Args>
+    Element* make(Element* next, Args&&... args);
+
+    /**
+     * \brief Destroys the values of the chain first ... last, if T needs
+     *        destroying.
+     */
+    static void destroyValues(Element* first, Element* last);
+
+    /**
+     * \brief Links the chain first ... last of count Elements in after
+     *        after, or at the front if after is nullptr.
+     */
+    void spliceChain(Element* after, Element* first, Element* last,
+                     size_t count);
+
+    /**
+     * \brief Makes other's Elements safe to relink into this list.
+     *
+     * \returns false if the lists' pools are incompatible, in which case
+     *          the values have to be copied instead.
+     */
+    bool adoptElementsOf(List& other);
+
+    /**
+     * \brief Lets the pool prepare for the values in [first, last), if
+     *        they can be counted without consuming them.
+     */
+    template <class InputIterator>
+    void reserveFor(InputIterator first, InputIterator last, size_t have);
+
+    /**
+     * \brief Merges the sorted, null-terminated chains a and b.
+     *
+     * \returns The head of the merged chain, and sets tail to its last
+     *          Element. Ties go to a.
+     */
+    static Element* mergeChains(Element* a, Element* b, Element*& tail);
+
+    /**
+     * \brief Sorts the null-terminated chain starting at head.
+     *
+     * \returns The new head, and sets tail to the new last Element.
+     */
+    static Element* sortChain(Element* head, Element*& tail);
+
+    /***
+     * \class Iterator
+     * \brief STL-style iterator for List.
+     */
+    class Iterator {
+    public:
+        // Definitions that are required for this class to be a well-behaved
+        // STL-style iterator that moves forward through a collection of Ts.
+        using value_type = T;
+        using reference = value_type&;
+        using pointer = value_type*;
+        using difference_type = ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        // Provide all the usual operations for a forward iterator
+
+        /**
+         * \brief Default constructors, assignment operators, and destructor.
+         */
+        Iterator() = default;
+        Iterator(const Iterator&) = default;
+        Iterator& operator=(const Iterator&) = default;
+        ~Iterator() = default;
+
+        /**
+         * \brief Overloads the prefix and postfix increment operators.
+         */
+        Iterator& operator++();
+        Iterator operator++(int);
+
+        /**
+         * \brief Overloads the dereference and member access operators.
+         */
+        T& operator*() const;
+        T* operator->() const;
+
+        /**
+         * \brief Overloads the (in)equality operators.
+         */
+        bool operator==(const Iterator& rhs) const;
+        bool operator!=(const Iterator& rhs) const;
+
+    private:
+        friend class List;
+        Iterator(Element* current);  ///< Friends create non-default iterators
+        Element* current_ = nullptr; ///< The current list node
+    };
+
+};
+
+/// Provide a non-member version of swap to allow standard swap(x,y) usage.
+template <class T, class Allocator>
+void swap(List<T, Allocator>& lhs, List<T, Allocator>& rhs) noexcept;
+
+#include "list-private.hpp"
+
+#endif // LIST_HPP_INCLUDED
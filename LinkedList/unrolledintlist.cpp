@@ -0,0 +1,315 @@
+/*
+ * \file unrolledintlist.cpp
+ * \authors Rachel Lee
+ * \brief Implemenation of UnrolledIntList, a chunked linked list of ints,
+ *        and its private classes.
+ */
+
+#include "unrolledintlist.hpp"
+#include "intkernels.hpp"
+#include "../Instrumentation/probes.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cassert>
+
+using namespace std;
+
+UnrolledIntList::UnrolledIntList() : back_{nullptr}, front_{nullptr}, size_{0} {
+}
+
+UnrolledIntList::UnrolledIntList(const UnrolledIntList& orig) :
+    back_{nullptr}, front_{nullptr}, size_{0} {
+    // push_back packs the copy densely, however sparse orig's Chunks are
+    for (iterator b = orig.begin(); b != orig.end(); ++b)  {
+        push_back(*b);
+    }
+}
+
+UnrolledIntList::~UnrolledIntList()
+{
+    // Free whole Chunks; there is no need to visit the values
+    while (front_ != nullptr) {
+        Chunk* next = front_->next_;
+        delete front_;
+        front_ = next;
+    }
+}
+
+void UnrolledIntList::swap(UnrolledIntList& rhs)
+{
+    using std::swap;
+
+    swap(back_, rhs.back_);
+    swap(front_, rhs.front_);
+    swap(size_, rhs.size_);
+}
+
+
+void swap(UnrolledIntList& lhs, UnrolledIntList& rhs)
+{
+    lhs.swap(rhs);
+}
+
+
+UnrolledIntList& UnrolledIntList::operator=(const UnrolledIntList& rhs)
+{
+    // Implemented idiomatically for C++, using "the swap trick"
+    UnrolledIntList copy = rhs;
+    swap(copy);
+    return *this;
+}
+
+
+size_t UnrolledIntList::size() const
+{
+    return size_;
+}
+
+bool UnrolledIntList::empty() const
+{
+    return size_ == 0;
+}
+
+
+bool UnrolledIntList::operator==(const UnrolledIntList& rhs) const
+{
+    return equals(rhs);
+}
+
+bool UnrolledIntList::operator!=(const UnrolledIntList& rhs) const
+{
+    // Idiomatic code: leverage == to implement !=
+    return !operator==(rhs);
+}
+
+
+long long UnrolledIntList::sum() const
+{
+    long long sum = 0;
+    for (const Chunk* chunk = front_; chunk != nullptr; chunk = chunk->next_)
+        sum += sumInts(chunk->values_ + chunk->first_,
+                       chunk->last_ - chunk->first_);
+    return sum;
+}
+
+
+size_t UnrolledIntList::count(int value) const
+{
+    size_t count = 0;
+    for (const Chunk* chunk = front_; chunk != nullptr; chunk = chunk->next_)
+        count += countInts(chunk->values_ + chunk->first_,
+                           chunk->last_ - chunk->first_, value);
+    return count;
+}
+
+
+UnrolledIntList::iterator UnrolledIntList::find(int value) const
+{
+    DATASTRUCTURES_PROBE("UnrolledIntList::find");
+    for (Chunk* chunk = front_; chunk != nullptr; chunk = chunk->next_) {
+        size_t n = chunk->last_ - chunk->first_;
+        size_t found = findInt(chunk->values_ + chunk->first_, n, value);
+        if (found != n)
+            return Iterator{chunk, chunk->first_ + found};
+    }
+    return end();
+}
+
+
+bool UnrolledIntList::equals(const UnrolledIntList& rhs) const
+{
+    // Cheap check
+    if (size_ != rhs.size_)
+        return false;
+
+    // The lists' Chunks need not line up, so compare the longest run that
+    // is contiguous in both, then step whichever Chunk ran out
+    const Chunk* a = front_;
+    const Chunk* b = rhs.front_;
+    size_t i = a == nullptr ? 0 : a->first_;
+    size_t j = b == nullptr ? 0 : b->first_;
+    while (a != nullptr) {
+        size_t run = min<size_t>(a->last_ - i, b->last_ - j);
+        if (!equalInts(a->values_ + i, b->values_ + j, run))
+            return false;
+        i += run;
+        j += run;
+        if (i == a->last_) {
+            a = a->next_;
+            i = a == nullptr ? 0 : a->first_;
+        }
+        if (j == b->last_) {
+            b = b->next_;
+            j = b == nullptr ? 0 : b->first_;
+        }
+    }
+    return true;
+}
+
+
+void UnrolledIntList::push_front(int pushee)
+{
+    DATASTRUCTURES_PROBE("UnrolledIntList::push_front");
+    if (front_ == nullptr || front_->first_ == 0) {
+        // No room at the start of the first Chunk, and shifting its values
+        // would move them out from under iterators, so start a new Chunk,
+        // filled from the top so later pushes fit in it
+        front_ = new Chunk{front_, uint16_t(Chunk::CAPACITY)};
+        if (back_ == nullptr)
+            back_ = front_;
+    }
+
+    front_->values_[--front_->first_] = pushee;
+    ++size_;
+}
+
+
+int UnrolledIntList::pop_front()
+{
+    DATASTRUCTURES_PROBE("UnrolledIntList::pop_front");
+    assert(!empty());
+
+    // Get our value before we (possibly) delete the Chunk
+    int value = front_->values_[front_->first_++];
+
+    if (front_->first_ == front_->last_) {
+        Chunk* first = front_;
+        front_ = first->next_;
+        if (front_ == nullptr)
+            back_ = nullptr;
+        delete first;
+    }
+    --size_;
+    return value;
+}
+
+
+void UnrolledIntList::push_back(int pushee)
+{
+    DATASTRUCTURES_PROBE("UnrolledIntList::push_back");
+    if (back_ == nullptr || back_->last_ == Chunk::CAPACITY) {
+        // No room at the end of the last Chunk; as in push_front(), link a
+        // new one rather than shift values under iterators. The new Chunk
+        // is the last one in the list, it doesn't need a next_
+        Chunk* last = new Chunk{nullptr, 0};
+        // Our more common case, a non-empty list
+        if (back_ != nullptr) {
+            back_->next_ = last;
+        } else { // The edge case of an empty list
+            front_ = last;
+        }
+        back_ = last;
+    }
+
+    back_->values_[back_->last_++] = pushee;
+    ++size_;
+}
+
+
+void UnrolledIntList::insert_after(iterator where, int value)
+{
+    DATASTRUCTURES_PROBE("UnrolledIntList::insert_after");
+    Chunk* chunk = where.current_;
+    size_t pos = where.index_ + 1;   // Where value goes within chunk
+
+    if (chunk->last_ - chunk->first_ == Chunk::CAPACITY) {
+        // Split a full Chunk, moving its upper half into a new one after it
+        size_t half = Chunk::CAPACITY / 2;
+        Chunk* upper = new Chunk{chunk->next_, 0};
+        copy(chunk->values_ + half, chunk->values_ + Chunk::CAPACITY,
+             upper->values_);
+        upper->last_ = uint16_t(Chunk::CAPACITY - half);
+        chunk->last_ = uint16_t(half);
+        chunk->next_ = upper;
+        if (back_ == chunk)
+            back_ = upper;
+
+        if (pos > half) {
+            chunk = upper;
+            pos -= half;
+        }
+    }
+
+    if (chunk->last_ < Chunk::CAPACITY) {
+        // Shift the values after pos up by one
+        copy_backward(chunk->values_ + pos, chunk->values_ + chunk->last_,
+                      chunk->values_ + chunk->last_ + 1);
+        ++chunk->last_;
+    } else {
+        // No room at the end, so shift the values before pos down by one
+        copy(chunk->values_ + chunk->first_, chunk->values_ + pos,
+             chunk->values_ + chunk->first_ - 1);
+        --chunk->first_;
+        --pos;
+    }
+    chunk->values_[pos] = value;
+    ++size_;
+}
+
+
+UnrolledIntList::iterator UnrolledIntList::begin() const
+{
+    // Iterator to the first element
+    if (front_ == nullptr)
+        return end();
+    return Iterator{front_, front_->first_};
+}
+
+
+UnrolledIntList::iterator UnrolledIntList::end() const
+{
+    // Iterator to an invalid element; if we have an iterator whose current_
+    // value is this then we've gone past the end of the list
+    return Iterator{nullptr, 0};
+}
+
+// --------------------------------------
+// Implementation of UnrolledIntList::Chunk
+// --------------------------------------
+
+UnrolledIntList::Chunk::Chunk(Chunk* next, uint16_t first)
+    : next_{next}, first_{first}, last_{first}
+{
+    // Nothing else to do
+}
+
+// --------------------------------------
+// Implementation of UnrolledIntList::Iterator
+// --------------------------------------
+
+UnrolledIntList::Iterator::Iterator(Chunk* current, size_t index)
+    : current_{current}, index_{index}
+{
+    // Nothing else to do
+}
+
+
+UnrolledIntList::Iterator& UnrolledIntList::Iterator::operator++()
+{
+    // Step within the Chunk, moving on to the next one when we run out
+    if (++index_ == current_->last_) {
+        current_ = current_->next_;
+        index_ = current_ == nullptr ? 0 : current_->first_;
+    }
+    return *this;
+}
+
+
+int& UnrolledIntList::Iterator::operator*() const
+{
+    // Return a reference to the current value
+    return current_->values_[index_];
+}
+
+bool UnrolledIntList::Iterator::operator==(const Iterator& rhs) const
+{
+    return rhs.current_ == current_ && rhs.index_ == index_;
+}
+
+
+bool UnrolledIntList::Iterator::operator!=(const Iterator& rhs) const
+{
+    // Idiomatic code: leverage == to implement !=
+    return !(*this == rhs);
+}
@@ -0,0 +1,227 @@
+/**
+ * \file unrolledintlist.hpp
+ * \authors Rachel Lee
+ * \brief A singly-linked list of ints, stored a cache line at a time.
+ */
+
+#ifndef UNROLLEDINTLIST_HPP_INCLUDED
+#define UNROLLEDINTLIST_HPP_INCLUDED 1
+
+#include <iostream>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+/**
+ * \class UnrolledIntList
+ *
+ * \brief A linked list of Chunk objects, each holding up to a cache line's
+ *        worth of \c ints.
+ *
+ * \details Offers the same interface as IntList. Because neighbouring values
+ *          share a node, iterating touches one cache line per Chunk rather
+ *          than one per value.
+ *
+ *          Unlike IntList, insert_after() may move the values in where's
+ *          Chunk, within it or into a new one, so it invalidates every
+ *          iterator into that Chunk. push_front() and push_back() never
+ *          move values, and pop_front() only invalidates iterators to the
+ *          value it removes.
+ */
+class UnrolledIntList {
+
+private:
+    // Forward declaration of private class.
+    class Iterator;
+
+public:
+
+    /**
+     * \brief The default constructor for the UnrolledIntList.
+     */
+    UnrolledIntList();
+
+    /**
+     * \brief The copy constructor for the UnrolledIntList.
+     */
+    UnrolledIntList(const UnrolledIntList& orig);
+
+    /**
+     * \brief Overloads the assignment operator for the UnrolledIntList.
+     */
+    UnrolledIntList& operator=(const UnrolledIntList& rhs);
+
+    /**
+     * \brief The destructor for the UnrolledIntList.
+     */
+    ~UnrolledIntList();
+
+    /**
+     * \brief Swap function for an UnrolledIntList.  
+     */
+    void swap(UnrolledIntList& rhs);
+
+    /**
+     * \brief Pushes a value onto the front of the list
+     * \post Size increased by one, pointers adjusted appropriately.
+     */
+    void push_front(int pushee);    ///< Push onto head of list
+
+    /**
+     * \brief Pushes a value onto the end of the list.
+     * \post Size increased by one, pointers adjusted appropriately.
+     */
+    void push_back(int pushee);     ///< Push onto tail of list
+    
+    /**
+     * \brief Removes the first value from the list.
+     * \post Size decreased by one, pointers adjusted appropriately.
+     */
+    int pop_front();                ///< Drop & return the head element
+
+    /**
+     * \brief Returns the number of integers in the list.
+     */
+    size_t size() const;            ///< Size of the list
+
+    /**
+     * \brief Returns whether there are no integers in the list.
+     */
+    bool empty() const;             ///< true if the list is empty
+ 
+    /**
+     * \brief Overloads the equality operator for UnrolledIntLists.
+     */
+    bool operator==(const UnrolledIntList& rhs) const;
+    
+    /**
+     * \brief Overloads the inequality operator for UnrolledIntLists.
+     */
+    bool operator!=(const UnrolledIntList& rhs) const;
+ 
+    // Allow clients to iterate over the contents of the list. 
+    using iterator = Iterator; 
+
+    /**
+     * \brief Returns an iterator to the front of the list.
+     */
+    iterator begin() const; ///< An iterator that refers to the first element
+
+    /**
+     * \brief Returns a 'null' iterator.
+     */
+    iterator end() const;   ///< An invalid / "past-the-end" iterator
+
+    /**
+     * \brief Returns the sum of the values in the list.
+     */
+    long long sum() const;
+
+    /**
+     * \brief Returns how many values in the list equal value.
+     */
+    size_t count(int value) const;
+
+    /**
+     * \brief Returns an iterator to the first value equal to value, or
+     *        end() if there is none.
+     */
+    iterator find(int value) const;
+
+    /**
+     * \brief Returns whether rhs holds the same values in the same order.
+     */
+    bool equals(const UnrolledIntList& rhs) const;
+
+    /**
+     * Insert a value after a given iterator
+     *
+     * \details The iterator cannot be end(), the list cannot be empty.
+     */
+    void insert_after(iterator where, int value);
+
+private:
+    /***
+     * \struct Chunk
+     *
+     * \brief The list is stored as a linked list of Chunks, each exactly
+     *        one cache line long. Values occupy values_[first_, last_), so
+     *        there can be spare room at either end.
+     *
+     * \details The Copy Constructor and Assignment operator are
+     *          disabled.
+     */
+    struct alignas(64) Chunk {
+        /// As many ints as fit in a cache line next to the bookkeeping
+        static constexpr size_t CAPACITY = 13;
+
+        Chunk*   next_;
+        uint16_t first_;   ///< Index of the first value in use
+        uint16_t last_;    ///< One past the index of the last value in use
+        int      values_[CAPACITY];
+
+        Chunk(Chunk* next, uint16_t first);
+
+        Chunk() = delete;
+        Chunk(const Chunk&) = delete;
+        Chunk& operator=(const Chunk&) = delete;
+        ~Chunk() = default;
+    };
+
+    Chunk*   back_;   ///< Current tail chunk of list
+    Chunk*   front_;  ///< Current head chunk of list
+    size_t   size_;   ///< Current size of list
+
+    /***
+     * \class Iterator
+     * \brief STL-style iterator for UnrolledIntList.
+     */
+    class Iterator {
+    public:
+        // Definitions that are required for this class to be a well-behaved
+        // STL-style iterator that moves forward through a collection of ints.
+        using value_type = int;
+        using reference = value_type&;
+        using pointer = value_type*;
+        using difference_type = ptrdiff_t;
+        using iterator_category = std::forward_iterator_tag;
+
+        // Provide all the usual operations for a forward iterator
+
+        /**
+         * \brief Default constructors, assignment operators, and destructor.
+         */
+        Iterator() = default;
+        Iterator(const Iterator&) = default;
+        Iterator& operator=(const Iterator&) = default;
+        ~Iterator() = default;
+
+        /**
+         * \brief Overloads the prefix increment operator.
+         */
+        Iterator& operator++();
+
+        /**
+         * \brief Overloads the dereference operator.
+         */
+        int& operator*() const;
+
+        /**
+         * \brief Overloads the (in)equality operators.
+         */
+        bool operator==(const Iterator& rhs) const;
+        bool operator!=(const Iterator& rhs) const;
+
+    private:
+        friend class UnrolledIntList;
+        Iterator(Chunk* current, size_t index);  ///< Friends create non-default iterators
+        Chunk* current_;           ///< The current list chunk
+        size_t index_;             ///< Position within current_->values_
+    };
+
+};
+
+/// Provide a non-member version of swap to allow standard swap(x,y) usage.
+void swap(UnrolledIntList& lhs, UnrolledIntList& rhs);
+
+#endif // UNROLLEDINTLIST_HPP_INCLUDED
@@ -0,0 +1,103 @@
+/*
+ * \file fixedblockresource.cpp
+ * \authors Rachel Lee
+ * \brief Implemenation of FixedBlockResource, a pooled memory resource
+ *        for blocks of one size.
+ */
+
+#include "fixedblockresource.hpp"
+
+using namespace std;
+
+/// Alignment of every chunk, and so the most a block can offer
+static constexpr size_t CHUNK_ALIGNMENT = alignof(max_align_t);
+
+FixedBlockResource::FixedBlockResource(size_t blockSize,
+                                       pmr::memory_resource* upstream)
+    : upstream_{upstream}, free_{nullptr}, unused_{nullptr},
+      chunkEnd_{nullptr}, chunks_{nullptr}, nextChunk_{FIRST_CHUNK}
+{
+    // Every block has to be able to hold a free-list link
+    const size_t LINK = sizeof(FreeBlock);
+    blockSize_ = (blockSize < LINK ? LINK : blockSize + LINK - 1) / LINK * LINK;
+
+    // Blocks are packed, so they are only as aligned as their size allows
+    blockAlignment_ = CHUNK_ALIGNMENT;
+    while (blockSize_ % blockAlignment_ != 0)
+        blockAlignment_ /= 2;
+}
+
+FixedBlockResource::~FixedBlockResource()
+{
+    release();
+}
+
+void FixedBlockResource::release()
+{
+    while (chunks_ != nullptr) {
+        Chunk* older = chunks_->next_;
+        upstream_->deallocate(chunks_, chunks_->size_, CHUNK_ALIGNMENT);
+        chunks_ = older;
+    }
+    free_ = nullptr;
+    unused_ = chunkEnd_ = nullptr;
+    nextChunk_ = FIRST_CHUNK;
+}
+
+size_t FixedBlockResource::blockSize() const
+{
+    return blockSize_;
+}
+
+void* FixedBlockResource::do_allocate(size_t bytes, size_t alignment)
+{
+    if (bytes > blockSize_ || alignment > blockAlignment_)
+        return upstream_->allocate(bytes, alignment);
+
+    if (free_ != nullptr) {
+        FreeBlock* block = free_;
+        free_ = block->next_;
+        return block;
+    }
+    if (unused_ == chunkEnd_)
+        grow();
+    void* block = unused_;
+    unused_ += blockSize_;
+    return block;
+}
+
+void FixedBlockResource::do_deallocate(void* memory, size_t bytes,
+                                       size_t alignment)
+{
+    if (bytes > blockSize_ || alignment > blockAlignment_) {
+        upstream_->deallocate(memory, bytes, alignment);
+        return;
+    }
+
+    FreeBlock* block = static_cast<FreeBlock*>(memory);
+    block->next_ = free_;
+    free_ = block;
+}
+
+bool FixedBlockResource::do_is_equal(const pmr::memory_resource& other) const
+    noexcept
+{
+    return this == &other;
+}
+
+void FixedBlockResource::grow()
+{
+    // The header takes up whole blocks, so the blocks stay aligned
+    size_t headerBlocks = (sizeof(Chunk) + blockSize_ - 1) / blockSize_;
+    size_t size = (headerBlocks + nextChunk_) * blockSize_;
+
+    Chunk* chunk = static_cast<Chunk*>(upstream_->allocate(size,
+                                                           CHUNK_ALIGNMENT));
+    chunk->next_ = chunks_;
+    chunk->size_ = size;
+    chunks_ = chunk;
+    unused_ = reinterpret_cast<char*>(chunk) + headerBlocks * blockSize_;
+    chunkEnd_ = reinterpret_cast<char*>(chunk) + size;
+    if (nextChunk_ < LARGEST_CHUNK)
+        nextChunk_ *= 2;
+}
@@ -0,0 +1,101 @@
+/*
+ * \file requestarena.cpp
+ * \authors Rachel Lee
+ * \brief Implemenation of RequestArena, a resettable bump-pointer memory
+ *        resource.
+ */
+
+#include "requestarena.hpp"
+
+#include <cstdint>
+
+using namespace std;
+
+/// Alignment of every chunk, and so the largest we can bump-align to
+static constexpr size_t CHUNK_ALIGNMENT = alignof(max_align_t);
+
+RequestArena::RequestArena(size_t firstChunk,
+                           pmr::memory_resource* upstream)
+    : upstream_{upstream}, chunks_{nullptr}, next_{nullptr}, end_{nullptr},
+      nextChunk_{firstChunk < 2 * sizeof(Chunk) ? 2 * sizeof(Chunk)
+                                                : firstChunk}
+{
+    // Nothing else to do
+}
+
+RequestArena::~RequestArena()
+{
+    releaseChunks();
+}
+
+void RequestArena::releaseChunks()
+{
+    while (chunks_ != nullptr) {
+        Chunk* older = chunks_->next_;
+        upstream_->deallocate(chunks_, chunks_->size_, CHUNK_ALIGNMENT);
+        chunks_ = older;
+    }
+    next_ = end_ = nullptr;
+}
+
+void* RequestArena::do_allocate(size_t bytes, size_t alignment)
+{
+    uintptr_t at = (uintptr_t(next_) + alignment - 1) & ~uintptr_t(alignment - 1);
+    if (next_ == nullptr || at + bytes > uintptr_t(end_)) {
+        grow(bytes, alignment);
+        at = (uintptr_t(next_) + alignment - 1) & ~uintptr_t(alignment - 1);
+    }
+    next_ = reinterpret_cast<char*>(at + bytes);
+    return reinterpret_cast<void*>(at);
+}
+
+void RequestArena::do_deallocate(void*, size_t, size_t)
+{
+    // Everything goes at once, in reset()
+}
+
+bool RequestArena::do_is_equal(const pmr::memory_resource& other) const
+    noexcept
+{
+    return this == &other;
+}
+
+void RequestArena::grow(size_t bytes, size_t alignment)
+{
+    size_t needed = sizeof(Chunk) + bytes
+                    + (alignment > CHUNK_ALIGNMENT ? alignment : 0);
+    size_t size = nextChunk_ < needed ? needed : nextChunk_;
+
+    Chunk* chunk = static_cast<Chunk*>(upstream_->allocate(size,
+                                                           CHUNK_ALIGNMENT));
+    chunk->next_ = chunks_;
+    chunk->size_ = size;
+    chunks_ = chunk;
+    next_ = reinterpret_cast<char*>(chunk + 1);
+    end_ = reinterpret_cast<char*>(chunk) + size;
+    nextChunk_ = 2 * size;
+}
+
+void RequestArena::reset()
+{
+    if (chunks_ == nullptr)
+        return;
+
+    // One chunk big enough for the whole of this request serves the next
+    if (chunks_->next_ != nullptr) {
+        size_t total = capacity();
+        releaseChunks();
+        nextChunk_ = total;
+        grow(0, 1);
+        return;
+    }
+    next_ = reinterpret_cast<char*>(chunks_ + 1);
+}
+
+size_t RequestArena::capacity() const
+{
+    size_t total = 0;
+    for (const Chunk* chunk = chunks_; chunk != nullptr; chunk = chunk->next_)
+        total += chunk->size_;
+    return total;
+}
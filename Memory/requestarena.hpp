@@ -0,0 +1,89 @@
+/**
+ * \file requestarena.hpp
+ * \authors Rachel Lee
+ * \brief A bump-pointer memory resource for containers that live for one
+ *        request.
+ */
+
+#ifndef REQUESTARENA_HPP_INCLUDED
+#define REQUESTARENA_HPP_INCLUDED 1
+
+#include <cstddef>
+#include <memory_resource>
+
+/**
+ * \class RequestArena
+ *
+ * \brief A monotonic std::pmr::memory_resource that is emptied all at once
+ *        by reset() and then reused.
+ *
+ * \details Allocation bumps a pointer; deallocation does nothing. Unlike
+ *          std::pmr::monotonic_buffer_resource, reset() keeps the memory:
+ *          if a request needed more than one chunk, the chunks are replaced
+ *          by a single one big enough for all of them, so once the arena
+ *          has seen a typical request it stops calling upstream at all.
+ *
+ *          Not thread-safe; use one arena per thread or per request.
+ */
+class RequestArena : public std::pmr::memory_resource {
+public:
+    /**
+     * \brief Constructs an arena whose first chunk holds firstChunk bytes,
+     *        taken from upstream when first needed.
+     */
+    explicit RequestArena(size_t firstChunk = 64 * 1024,
+                          std::pmr::memory_resource* upstream =
+                              std::pmr::new_delete_resource());
+
+    /**
+     * \brief Disabled copy constructor and assignment operator.
+     */
+    RequestArena(const RequestArena&) = delete;
+    RequestArena& operator=(const RequestArena&) = delete;
+
+    /**
+     * \brief The destructor; hands every chunk back to upstream.
+     */
+    ~RequestArena() override;
+
+    /**
+     * \brief Frees everything allocated from the arena in one go.
+     *
+     * \warning Nothing allocated from the arena may be used afterwards;
+     *          destroy the request's containers first.
+     */
+    void reset();
+
+    /**
+     * \brief Returns the bytes the arena holds, used or not.
+     */
+    size_t capacity() const;
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* memory, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const
+        noexcept override;
+
+    /**
+     * \brief Header at the start of every chunk.
+     */
+    struct Chunk {
+        Chunk* next_;  ///< Older chunk
+        size_t size_;  ///< Bytes in the chunk, header included
+    };
+
+    // Adds a chunk with room for bytes at alignment
+    void grow(size_t bytes, size_t alignment);
+
+    // Hands the chunks back to upstream
+    void releaseChunks();
+
+    std::pmr::memory_resource* upstream_;
+    Chunk* chunks_;     ///< Newest first; next_ points into the newest
+    char* next_;        ///< First free byte of the newest chunk
+    char* end_;         ///< End of the newest chunk
+    size_t nextChunk_;  ///< Size of the next chunk to add
+};
+
+#endif // REQUESTARENA_HPP_INCLUDED
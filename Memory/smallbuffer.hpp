@@ -0,0 +1,196 @@
+/**
+ * \file smallbuffer.hpp
+ * \authors Rachel Lee
+ * \brief Provides SmallBuffer<T, N>, inline storage for up to N items that
+ *        the set classes use before they build their real structure.
+ */
+
+#ifndef SMALLBUFFER_HPP_INCLUDED
+#define SMALLBUFFER_HPP_INCLUDED 1
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/**
+ * \class SmallBuffer
+ *
+ * \brief Up to N items stored in place, in insertion order, with no
+ *        allocation.
+ *
+ * \details contains() is a linear scan, four ints at a time with SSE2; for
+ *          the handful of items a SmallBuffer is meant for, that beats
+ *          hashing or descending a tree.
+ */
+template <class T, size_t N>
+class SmallBuffer {
+public:
+    SmallBuffer() = default; ///< Default constructor
+
+    ~SmallBuffer(); ///< Destructor
+
+    SmallBuffer(const SmallBuffer& copy) = delete;
+
+    SmallBuffer& operator=(const SmallBuffer& rhs) = delete;
+
+    size_t size() const;  ///< Number of items held
+    bool full() const;    ///< True if there is no room for another item
+
+    /**
+     * \brief Returns true if an item equal to item is held.
+     */
+    bool contains(const T& item) const;
+
+    /**
+     * \brief Returns true if an item equivalent to item under operator<
+     *        is held.
+     */
+    bool containsEquivalent(const T& item) const;
+
+    /**
+     * \brief Adds item at the end.
+     * \pre !full()
+     */
+    void push_back(const T& item);
+
+    const T* begin() const;  ///< The first item
+    const T* end() const;    ///< Just past the last item
+
+    /**
+     * \brief Destroys every item.
+     */
+    void clear();
+
+private:
+    T* items();
+    const T* items() const;
+
+    alignas(T) unsigned char storage_[N * sizeof(T)];
+    std::uint32_t size_ = 0;
+};
+
+/**
+ * \brief SmallBuffer with no room at all, for sets that don't want one; it
+ *        is always full and always empty.
+ */
+template <class T>
+class SmallBuffer<T, 0> {
+public:
+    size_t size() const { return 0; }
+    bool full() const { return true; }
+    bool contains(const T&) const { return false; }
+    bool containsEquivalent(const T&) const { return false; }
+    void push_back(const T&) { }
+    const T* begin() const { return nullptr; }
+    const T* end() const { return nullptr; }
+    void clear() { }
+};
+
+template <class T, size_t N>
+SmallBuffer<T, N>::~SmallBuffer()
+{
+    clear();
+}
+
+template <class T, size_t N>
+size_t SmallBuffer<T, N>::size() const
+{
+    return size_;
+}
+
+template <class T, size_t N>
+bool SmallBuffer<T, N>::full() const
+{
+    return size_ == N;
+}
+
+template <class T, size_t N>
+T* SmallBuffer<T, N>::items()
+{
+    return reinterpret_cast<T*>(storage_);
+}
+
+template <class T, size_t N>
+const T* SmallBuffer<T, N>::items() const
+{
+    return reinterpret_cast<const T*>(storage_);
+}
+
+template <class T, size_t N>
+bool SmallBuffer<T, N>::contains(const T& item) const
+{
+    const T* here = items();
+    size_t i = 0;
+
+#if defined(__SSE2__)
+    if constexpr (std::is_same<T, int>::value) {
+        __m128i wanted = _mm_set1_epi32(item);
+        for (; i + 4 <= size_; i += 4) {
+            __m128i four = _mm_loadu_si128(
+                reinterpret_cast<const __m128i*>(here + i));
+            if (_mm_movemask_epi8(_mm_cmpeq_epi32(four, wanted)) != 0)
+                return true;
+        }
+    }
+#endif
+
+    for (; i < size_; ++i) {
+        if (here[i] == item)
+            return true;
+    }
+    return false;
+}
+
+template <class T, size_t N>
+bool SmallBuffer<T, N>::containsEquivalent(const T& item) const
+{
+    // Equivalence is equality for integers, and that scan is vectorized;
+    // not for floating point, where NaN and -0.0 tell the two apart
+    if constexpr (std::is_integral<T>::value) {
+        return contains(item);
+    } else {
+        for (const T& held : *this) {
+            if (!(held < item) && !(item < held))
+                return true;
+        }
+        return false;
+    }
+}
+
+template <class T, size_t N>
+void SmallBuffer<T, N>::push_back(const T& item)
+{
+    ::new (static_cast<void*>(storage_ + size_ * sizeof(T))) T(item);
+    ++size_;
+}
+
+template <class T, size_t N>
+const T* SmallBuffer<T, N>::begin() const
+{
+    return items();
+}
+
+template <class T, size_t N>
+const T* SmallBuffer<T, N>::end() const
+{
+    return items() + size_;
+}
+
+template <class T, size_t N>
+void SmallBuffer<T, N>::clear()
+{
+    if constexpr (!std::is_trivially_destructible<T>::value) {
+        T* here = items();
+        for (size_t i = 0; i < size_; ++i)
+            here[i].~T();
+    }
+    size_ = 0;
+}
+
+#endif // SMALLBUFFER_HPP_INCLUDED
@@ -0,0 +1,152 @@
+/*
+ * \file concurrencytest.cpp
+ * \authors Rachel Lee
+ * \brief Stresses ConcurrentTreeSet and ConcurrentIntQueue from many
+ *        threads at once; meant to be run under ThreadSanitizer.
+ *
+ * \details Besides giving TSan something to watch, each test checks what
+ *          the containers promise: a ConcurrentTreeSet reader always finds
+ *          items inserted before it started and sees each range scan in
+ *          order, and a ConcurrentIntQueue hands out every value exactly
+ *          once, in each producer's order, without touching the slots a
+ *          pop leaves unfilled.
+ */
+
+#include "../LinkedList/concurrentintqueue.hpp"
+#include "../Tree/RandomizedBST/concurrenttreeset.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+[[noreturn]] static void failed(const char* condition, const char* file,
+                                int line)
+{
+    fprintf(stderr, "%s:%d: check failed: %s\n", file, line, condition);
+    abort();
+}
+
+#define CHECK(condition) \
+    ((condition) ? (void)0 : failed(#condition, __FILE__, __LINE__))
+
+static void treeSetReadersAndWriters()
+{
+    const int LOADED = 2000;
+    const int KEYS = 8000;
+    const size_t READERS = 4;
+    const size_t WRITERS = 2;
+
+    // Even keys are loaded up front; the writers add odd ones, overlapping
+    // each other so some inserts are duplicates
+    ConcurrentTreeSet<int> set;
+    for (int key = 0; key < LOADED; ++key)
+        set.insert(2 * key);
+
+    atomic<bool> done{false};
+    vector<thread> threads;
+    for (size_t r = 0; r < READERS; ++r) {
+        threads.emplace_back([&, r] {
+            for (int pass = 0; !done; ++pass) {
+                int key = int((r * 7919 + size_t(pass) * 104729) % LOADED);
+                CHECK(set.exists(2 * key));
+
+                int previous = -1;
+                set.forEachInRange(key, key + 200, [&](int item) {
+                    CHECK(item > previous && item >= key && item < key + 200);
+                    previous = item;
+                });
+            }
+        });
+    }
+
+    vector<thread> writers;
+    for (size_t w = 0; w < WRITERS; ++w) {
+        writers.emplace_back([&, w] {
+            for (int i = 0; i < KEYS; ++i)
+                set.insert(2 * ((i * 31 + int(w) * 17) % KEYS) + 1);
+        });
+    }
+    for (thread& writer : writers)
+        writer.join();
+    done = true;
+    for (thread& reader : threads)
+        reader.join();
+
+    CHECK(set.size() == size_t(LOADED + KEYS));
+    for (int key = 0; key < KEYS; ++key)
+        CHECK(set.exists(2 * key + 1));
+}
+
+static void queueProducersAndConsumers()
+{
+    const int EACH = 20000;
+    const int PRODUCERS = 4;
+    const int CONSUMERS = 4;
+    const size_t BATCH = 16;
+
+    // Producer p pushes p * EACH, ..., p * EACH + EACH - 1 in order
+    ConcurrentIntQueue queue;
+    atomic<int> popped{0};
+    vector<atomic<int>> seen(size_t(PRODUCERS * EACH));
+    for (atomic<int>& count : seen)
+        count = 0;
+
+    vector<thread> threads;
+    for (int p = 0; p < PRODUCERS; ++p) {
+        threads.emplace_back([&, p] {
+            for (int i = 0; i < EACH; ++i)
+                queue.push_back(p * EACH + i);
+        });
+    }
+    for (int c = 0; c < CONSUMERS; ++c) {
+        threads.emplace_back([&, c] {
+            // A consumer sees each producer's values in increasing order
+            vector<int> last(PRODUCERS, -1);
+            int values[BATCH];
+            while (popped < PRODUCERS * EACH) {
+                // A pop must leave the slots it doesn't fill alone, even
+                // when it loses a race with another consumer
+                fill(begin(values), end(values), -1);
+                size_t got;
+                if (c % 2 == 0) {
+                    got = queue.try_pop_front(values[0]) ? 1 : 0;
+                } else {
+                    got = queue.try_pop_many(values, BATCH);
+                }
+                for (size_t i = got; i < BATCH; ++i)
+                    CHECK(values[i] == -1);
+                if (got == 0) {
+                    this_thread::yield();
+                    continue;
+                }
+                for (size_t i = 0; i < got; ++i) {
+                    int value = values[i];
+                    CHECK(value >= 0 && value < PRODUCERS * EACH);
+                    CHECK(value > last[value / EACH]);
+                    last[value / EACH] = value;
+                    ++seen[size_t(value)];
+                }
+                popped += int(got);
+            }
+        });
+    }
+    for (thread& worker : threads)
+        worker.join();
+
+    CHECK(queue.empty());
+    for (atomic<int>& count : seen)
+        CHECK(count == 1);
+}
+
+int main()
+{
+    treeSetReadersAndWriters();
+    queueProducersAndConsumers();
+    printf("concurrency tests passed\n");
+    return 0;
+}
@@ -0,0 +1,356 @@
+/*
+ * \file differentialtest.cpp
+ * \authors Rachel Lee
+ * \brief Runs the same random operations against HashSet, TreeSet,
+ *        IntList and UnrolledIntList and against the std containers they
+ *        stand in for, and fails on the first difference or broken
+ *        invariant.
+ *
+ * \details The operations are decoded from a string of bytes. Normally
+ *          main() makes those bytes from a series of seeds (--seeds and
+ *          --ops set how many seeds and how many operations each); built
+ *          with DATASTRUCTURES_LIBFUZZER, libFuzzer supplies them instead.
+ */
+
+// myhash() has to be declared before HashSet's definitions use it
+#include "../HashTable/stringhash.hpp"
+#include "../HashTable/hashset.hpp"
+#include "../LinkedList/intlist.hpp"
+#include "../LinkedList/intlistio.hpp"
+#include "../LinkedList/unrolledintlist.hpp"
+#include "../Tree/RandomizedBST/treeset.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <list>
+#include <numeric>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+/// Keys are drawn from [0, KEYS), so lookups hit about as often as miss
+static const unsigned KEYS = 512;
+
+/// Seed being run, for the failure message; unused under libFuzzer
+static uint64_t currentSeed = 0;
+
+[[noreturn]] static void failed(const char* condition, const char* file,
+                                int line)
+{
+    fprintf(stderr, "%s:%d: check failed: %s (seed %llu)\n", file, line,
+            condition, (unsigned long long)currentSeed);
+    abort();
+}
+
+#define CHECK(condition) \
+    ((condition) ? (void)0 : failed(#condition, __FILE__, __LINE__))
+
+/**
+ * \class Ops
+ *
+ * \brief Reads a string of bytes as operation codes and keys; once the
+ *        bytes run out, done() is true.
+ */
+class Ops {
+public:
+    Ops(const uint8_t* data, size_t size) : data_{data}, size_{size}, at_{0}
+    {
+    }
+
+    bool done() const
+    {
+        return at_ >= size_;
+    }
+
+    unsigned code(unsigned choices)
+    {
+        return byte() % choices;
+    }
+
+    unsigned key()
+    {
+        unsigned low = byte();
+        return (low | unsigned(byte()) << 8) % KEYS;
+    }
+
+private:
+    uint8_t byte()
+    {
+        return at_ < size_ ? data_[at_++] : 0;
+    }
+
+    const uint8_t* data_;
+    size_t size_;
+    size_t at_;
+};
+
+// Odd keys make strings too long for std::string's small buffer, so the
+// sets hold a mix of inline and heap strings
+static string keyString(unsigned key)
+{
+    if (key % 2 == 0)
+        return "k" + to_string(key);
+    return "a key long enough for the heap " + to_string(key);
+}
+
+template <class Set>
+static void hashSetAgainstStd(Ops ops)
+{
+    Set set;
+    std::set<string> reference;
+
+    while (!ops.done()) {
+        string key = keyString(ops.key());
+        switch (ops.code(3)) {
+        case 0:
+            set.insert(key);
+            reference.insert(key);
+            break;
+        case 1:
+            CHECK(set.exists(key) == (reference.count(key) != 0));
+            break;
+        default:
+            CHECK(set.consistent());
+            break;
+        }
+        CHECK(set.size() == reference.size());
+    }
+
+    CHECK(set.consistent());
+    for (const string& key : reference)
+        CHECK(set.exists(key));
+}
+
+template <class Set>
+static void treeSetAgainstStd(Ops ops)
+{
+    Set set;
+    std::set<int> reference;
+
+    while (!ops.done()) {
+        int key = int(ops.key()) - int(KEYS / 2);
+        switch (ops.code(4)) {
+        case 0:
+        case 1:
+            set.insert(key);
+            reference.insert(key);
+            break;
+        case 2:
+            CHECK(set.exists(key) == (reference.count(key) != 0));
+            break;
+        default: {
+            CHECK(set.consistent());
+            TreeSnapshot<int> snapshot = set.compact();
+            CHECK(snapshot.size() == reference.size());
+            CHECK(snapshot.exists(key) == (reference.count(key) != 0));
+            break;
+        }
+        }
+        CHECK(set.size() == reference.size());
+    }
+
+    CHECK(set.consistent());
+    for (int key : reference)
+        CHECK(set.exists(key));
+
+    // A bulk load of the same items, given in reverse, must agree
+    vector<int> items(reference.rbegin(), reference.rend());
+    Set loaded(items.begin(), items.end());
+    CHECK(loaded.consistent());
+    CHECK(loaded.size() == reference.size());
+    for (int key : reference)
+        CHECK(loaded.exists(key));
+}
+
+static void intListAgainstStd(Ops ops)
+{
+    IntList list;
+    std::list<int> reference;
+
+    while (!ops.done()) {
+        int value = int(ops.key() % 64);
+        switch (ops.code(8)) {
+        case 0:
+            list.push_back(value);
+            reference.push_back(value);
+            break;
+        case 1:
+            list.push_front(value);
+            reference.push_front(value);
+            break;
+        case 2:
+            if (!reference.empty()) {
+                CHECK(list.pop_front() == reference.front());
+                reference.pop_front();
+            }
+            break;
+        case 3:
+            CHECK(list.count(value)
+                  == size_t(count(reference.begin(), reference.end(), value)));
+            break;
+        case 4: {
+            // Insert after the first match, if there is one
+            auto where = find(reference.begin(), reference.end(), value);
+            bool missing = list.find(value) == list.end();
+            CHECK(missing == (where == reference.end()));
+            if (where != reference.end()) {
+                list.insert_after(list.find(value), value + 1);
+                reference.insert(next(where), value + 1);
+            }
+            break;
+        }
+        case 5:
+            CHECK(list.sum() == IntList::sum_type(
+                                    accumulate(reference.begin(),
+                                               reference.end(), 0LL)));
+            break;
+        case 6:
+            // Sorting is O(n log n), so keep it rare
+            if (value == 0) {
+                list.sort();
+                reference.sort();
+            }
+            break;
+        default: {
+            IntList copy{list};
+            CHECK(copy == list);
+            CHECK(copy.consistent());
+            break;
+        }
+        }
+        CHECK(list.size() == reference.size());
+        CHECK(list.consistent());
+    }
+
+    CHECK(equal(list.begin(), list.end(), reference.begin(), reference.end()));
+
+    // Saving and loading round-trips, and loading leaves what follows the
+    // list in the stream
+    for (IntListEncoding encoding :
+         {IntListEncoding::RAW, IntListEncoding::DELTA_VARINT}) {
+        stringstream stream;
+        CHECK(save(list, stream, encoding));
+        stream << "after";
+        IntList loaded;
+        CHECK(load(stream, loaded));
+        CHECK(loaded == list);
+        string rest;
+        stream >> rest;
+        CHECK(rest == "after");
+    }
+}
+
+static void unrolledIntListAgainstStd(Ops ops)
+{
+    UnrolledIntList list;
+    std::list<int> reference;
+
+    while (!ops.done()) {
+        int value = int(ops.key() % 64);
+        // Pushes don't move values, so an iterator taken before one still
+        // reads the same value after it
+        UnrolledIntList::iterator held = list.find(value);
+        switch (ops.code(6)) {
+        case 0:
+            list.push_back(value + 1);
+            reference.push_back(value + 1);
+            CHECK(held == list.end() || *held == value);
+            break;
+        case 1:
+            list.push_front(value + 1);
+            reference.push_front(value + 1);
+            CHECK(held == list.end() || *held == value);
+            break;
+        case 2:
+            if (!reference.empty()) {
+                CHECK(list.pop_front() == reference.front());
+                reference.pop_front();
+            }
+            break;
+        case 3:
+            CHECK(list.count(value)
+                  == size_t(count(reference.begin(), reference.end(), value)));
+            break;
+        case 4: {
+            auto where = find(reference.begin(), reference.end(), value);
+            CHECK((held == list.end()) == (where == reference.end()));
+            if (where != reference.end()) {
+                list.insert_after(held, value + 1);
+                reference.insert(next(where), value + 1);
+            }
+            break;
+        }
+        default: {
+            CHECK(list.sum() == accumulate(reference.begin(), reference.end(),
+                                           0LL));
+            UnrolledIntList copy{list};
+            CHECK(copy == list);
+            break;
+        }
+        }
+        CHECK(list.size() == reference.size());
+    }
+
+    CHECK(equal(list.begin(), list.end(), reference.begin(), reference.end()));
+}
+
+// Runs every container over the same operations
+static void runAll(const uint8_t* data, size_t size)
+{
+    Ops ops{data, size};
+    hashSetAgainstStd<HashSet<string>>(ops);
+    hashSetAgainstStd<SmallHashSet<string, 4>>(ops);
+    treeSetAgainstStd<TreeSet<int>>(ops);
+    treeSetAgainstStd<SmallTreeSet<int, 8>>(ops);
+    treeSetAgainstStd<TreeSet<int, uint16_t>>(ops);
+    intListAgainstStd(ops);
+    unrolledIntListAgainstStd(ops);
+}
+
+#ifdef DATASTRUCTURES_LIBFUZZER
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size)
+{
+    runAll(data, size);
+    return 0;
+}
+
+#else
+
+int main(int argc, char** argv)
+{
+    uint64_t seeds = 200;
+    size_t ops = 3000;
+    for (int i = 1; i + 1 < argc; i += 2) {
+        unsigned long long value = strtoull(argv[i + 1], nullptr, 10);
+        if (strcmp(argv[i], "--seeds") == 0) {
+            seeds = value;
+        } else if (strcmp(argv[i], "--ops") == 0) {
+            ops = size_t(value);
+        } else {
+            fprintf(stderr, "unknown option %s\n", argv[i]);
+            return 2;
+        }
+    }
+
+    // Three bytes make one operation: a code and a two-byte key
+    vector<uint8_t> bytes(3 * ops);
+    for (currentSeed = 0; currentSeed < seeds; ++currentSeed) {
+        mt19937_64 random{currentSeed};
+        for (uint8_t& byte : bytes)
+            byte = uint8_t(random());
+        runAll(bytes.data(), bytes.size());
+    }
+    printf("%llu seeds of %zu operations passed\n",
+           (unsigned long long)seeds, ops);
+    return 0;
+}
+
+#endif
@@ -0,0 +1,303 @@
+/**
+ * \file btreeset-private.hpp
+ *
+ * \author Rachel Lee
+ *
+ * \brief Implements BTreeSet<T>, a B+-tree set class template
+ *
+ * \remark There is no include-guard for this file, because it is
+ *         only #included by btreeset.hpp, inside btreeset.hpp's
+ *         own include guard.
+ */
+
+#include <algorithm>
+#include <type_traits>
+#include <utility>
+
+#include "../../Instrumentation/probes.hpp"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+template <class T, size_t B>
+BTreeSet<T, B>::BTreeSet() :
+    root_{nullptr}, firstLeaf_{nullptr}, size_{0}, height_{-1}, nodes_{0}
+{
+    // Nothing else to do
+}
+
+template <class T, size_t B>
+BTreeSet<T, B>::~BTreeSet()
+{
+    if (root_ != nullptr)
+        deleteNode(root_);
+}
+
+template <class T, size_t B>
+void BTreeSet<T, B>::deleteNode(Node* here)
+{
+    if (here->leaf_) {
+        delete static_cast<Leaf*>(here);
+    } else {
+        Inner* inner = static_cast<Inner*>(here);
+        for (size_t i = 0; i <= inner->count_; ++i)
+            deleteNode(inner->children_[i]);
+        delete inner;
+    }
+}
+
+template <class T, size_t B>
+size_t BTreeSet<T, B>::size() const
+{
+    return size_;
+}
+
+template <class T, size_t B>
+int BTreeSet<T, B>::height() const
+{
+    return height_;
+}
+
+template <class T, size_t B>
+size_t BTreeSet<T, B>::countLess(const T* keys, size_t count, const T& item)
+{
+    if constexpr (std::is_arithmetic<T>::value) {
+        size_t less = 0;
+        size_t i = 0;
+#if defined(__SSE2__)
+        if constexpr (std::is_same<T, int>::value) {
+            __m128i needle = _mm_set1_epi32(item);
+            for (; i + 4 <= count; i += 4) {
+                __m128i block = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(keys + i));
+                int mask = _mm_movemask_ps(
+                    _mm_castsi128_ps(_mm_cmplt_epi32(block, needle)));
+                less += __builtin_popcount(mask);
+            }
+        }
+#endif
+        // Counting rather than searching keeps the loop free of branches
+        for (; i < count; ++i)
+            less += size_t(keys[i] < item);
+        return less;
+    } else {
+        return std::lower_bound(keys, keys + count, item) - keys;
+    }
+}
+
+template <class T, size_t B>
+size_t BTreeSet<T, B>::countNotGreater(const T* keys, size_t count,
+                                       const T& item)
+{
+    if constexpr (std::is_arithmetic<T>::value) {
+        size_t greater = 0;
+        size_t i = 0;
+#if defined(__SSE2__)
+        if constexpr (std::is_same<T, int>::value) {
+            __m128i needle = _mm_set1_epi32(item);
+            for (; i + 4 <= count; i += 4) {
+                __m128i block = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(keys + i));
+                int mask = _mm_movemask_ps(
+                    _mm_castsi128_ps(_mm_cmpgt_epi32(block, needle)));
+                greater += __builtin_popcount(mask);
+            }
+        }
+#endif
+        for (; i < count; ++i)
+            greater += size_t(item < keys[i]);
+        return count - greater;
+    } else {
+        return std::upper_bound(keys, keys + count, item) - keys;
+    }
+}
+
+template <class T, size_t B>
+void BTreeSet<T, B>::insert(const T& item)
+{
+    DATASTRUCTURES_PROBE("BTreeSet::insert");
+    if (root_ == nullptr) {
+        firstLeaf_ = new Leaf;
+        root_ = firstLeaf_;
+        height_ = 0;
+        ++nodes_;
+    }
+
+    T splitKey;
+    Node* splitNode = nullptr;
+    if (!insertNode(root_, item, splitKey, splitNode))
+        return;
+    ++size_;
+
+    // The root split, so the tree grows a level at the top
+    if (splitNode != nullptr) {
+        Inner* root = new Inner;
+        root->keys_[0] = std::move(splitKey);
+        root->children_[0] = root_;
+        root->children_[1] = splitNode;
+        root->count_ = 1;
+        root_ = root;
+        ++height_;
+        ++nodes_;
+    }
+}
+
+template <class T, size_t B>
+bool BTreeSet<T, B>::insertNode(Node* here, const T& item, T& splitKey,
+                                Node*& splitNode)
+{
+    if (here->leaf_)
+        return insertLeaf(static_cast<Leaf*>(here), item, splitKey, splitNode);
+
+    Inner* inner = static_cast<Inner*>(here);
+    size_t i = countNotGreater(inner->keys_, inner->count_, item);
+
+    T childKey;
+    Node* childSplit = nullptr;
+    if (!insertNode(inner->children_[i], item, childKey, childSplit))
+        return false;
+
+    if (childSplit != nullptr)
+        insertChild(inner, i, childKey, childSplit, splitKey, splitNode);
+    return true;
+}
+
+template <class T, size_t B>
+bool BTreeSet<T, B>::insertLeaf(Leaf* here, const T& item, T& splitKey,
+                                Node*& splitNode)
+{
+    size_t pos = countLess(here->keys_, here->count_, item);
+    if (pos < here->count_ && !(item < here->keys_[pos]))
+        return false;
+
+    Leaf* target = here;
+    if (here->count_ == B) {
+        // Move the upper half into a new leaf to the right
+        Leaf* right = new Leaf;
+        ++nodes_;
+        size_t half = B / 2;
+        std::move(here->keys_ + half, here->keys_ + B, right->keys_);
+        right->count_ = B - half;
+        here->count_ = half;
+        right->next_ = here->next_;
+        here->next_ = right;
+
+        if (pos > half) {
+            target = right;
+            pos -= half;
+        }
+        splitNode = right;
+    }
+
+    std::move_backward(target->keys_ + pos, target->keys_ + target->count_,
+                       target->keys_ + target->count_ + 1);
+    target->keys_[pos] = item;
+    ++target->count_;
+
+    if (splitNode != nullptr)
+        splitKey = static_cast<Leaf*>(splitNode)->keys_[0];
+    return true;
+}
+
+template <class T, size_t B>
+void BTreeSet<T, B>::insertChild(Inner* here, size_t i, const T& key,
+                                 Node* child, T& splitKey, Node*& splitNode)
+{
+    if (here->count_ < B) {
+        std::move_backward(here->keys_ + i, here->keys_ + here->count_,
+                           here->keys_ + here->count_ + 1);
+        std::move_backward(here->children_ + i + 1,
+                           here->children_ + here->count_ + 1,
+                           here->children_ + here->count_ + 2);
+        here->keys_[i] = key;
+        here->children_[i + 1] = child;
+        ++here->count_;
+        return;
+    }
+
+    // Lay out all B + 1 keys and B + 2 children, then split around the
+    // middle key, which moves up to the parent
+    T keys[B + 1];
+    Node* children[B + 2];
+    std::move(here->keys_, here->keys_ + i, keys);
+    keys[i] = key;
+    std::move(here->keys_ + i, here->keys_ + B, keys + i + 1);
+    std::copy(here->children_, here->children_ + i + 1, children);
+    children[i + 1] = child;
+    std::copy(here->children_ + i + 1, here->children_ + B + 1,
+              children + i + 2);
+
+    size_t mid = (B + 1) / 2;
+    Inner* right = new Inner;
+    ++nodes_;
+
+    std::move(keys, keys + mid, here->keys_);
+    std::copy(children, children + mid + 1, here->children_);
+    here->count_ = mid;
+
+    std::move(keys + mid + 1, keys + B + 1, right->keys_);
+    std::copy(children + mid + 1, children + B + 2, right->children_);
+    right->count_ = B - mid;
+
+    splitKey = std::move(keys[mid]);
+    splitNode = right;
+}
+
+template <class T, size_t B>
+bool BTreeSet<T, B>::exists(const T& item) const
+{
+    DATASTRUCTURES_PROBE("BTreeSet::exists");
+    if (root_ == nullptr)
+        return false;
+
+    const Node* here = root_;
+    while (!here->leaf_) {
+        const Inner* inner = static_cast<const Inner*>(here);
+        here = inner->children_[countNotGreater(inner->keys_, inner->count_,
+                                                item)];
+    }
+
+    size_t pos = countLess(here->keys_, here->count_, item);
+    return pos < here->count_ && !(item < here->keys_[pos]);
+}
+
+template <class T, size_t B>
+void BTreeSet<T, B>::showStatistics(std::ostream& out) const
+{
+    out << "height " << height() << ", size " << size()
+        << ", nodes " << nodes_ << std::endl;
+}
+
+template <class T, size_t B>
+std::ostream& BTreeSet<T, B>::print(std::ostream& out) const
+{
+    for (const Leaf* leaf = firstLeaf_; leaf != nullptr; leaf = leaf->next_) {
+        out << "[";
+        for (size_t i = 0; i < leaf->count_; ++i)
+            out << (i == 0 ? "" : ", ") << leaf->keys_[i];
+        out << "]";
+    }
+    return out;
+}
+
+template <class T, size_t B>
+BTreeSet<T, B>::Node::Node(bool leaf) :
+    leaf_{leaf}, count_{0}
+{
+    // Nothing else to do
+}
+
+template <class T, size_t B>
+BTreeSet<T, B>::Leaf::Leaf() :
+    Node{true}, next_{nullptr}
+{
+    // Nothing else to do
+}
+
+template <class T, size_t B>
+BTreeSet<T, B>::Inner::Inner() :
+    Node{false}
+{
+    // Nothing else to do
+}
@@ -0,0 +1,159 @@
+/**
+ * \file btreeset.hpp
+ *
+ * \author Rachel Lee
+ *
+ * \brief Provides BTreeSet<T>, a set class template, using a B+-tree
+ */
+
+#ifndef BTREESET_HPP_INCLUDED
+#define BTREESET_HPP_INCLUDED 1
+
+#include <cstddef>
+#include <iostream>
+
+/**
+ * \class BTreeSet
+ *
+ * \brief An ordered set stored in a B+-tree with up to B keys per node.
+ *
+ * \details Offers the same interface as TreeSet, so either can be used.
+ *          Wide nodes mean one cache line fetch compares several keys.
+ *          For arithmetic T the keys inside a node are scanned without
+ *          branching, using SSE2 for ints. Other types use a binary search
+ *          inside the node. T must be default constructible.
+ */
+template <class T, size_t B = 32>
+class BTreeSet {
+    static_assert(B >= 4, "BTreeSet nodes need room for at least 4 keys");
+
+private:
+    struct Node;
+    struct Leaf;
+    struct Inner;
+
+public:
+    BTreeSet(); ///< Default constructor
+
+    ~BTreeSet(); ///< Destructor
+    
+    BTreeSet(const BTreeSet& copy) = delete;
+    
+    BTreeSet& operator=(const BTreeSet& rhs) = delete;
+
+    size_t size() const; ///< Number of items in the BTreeSet.
+
+    int height() const; ///< Returns height of the tree.
+
+    /**
+     * \brief Adds item to the BTreeSet. 
+     *
+     * \note Inserting an item that is already present has no effect.
+     */
+    void insert(const T&);
+ 
+    /**
+     * \brief Returns true if item is present in the BTreeSet and
+     *        false otherwise. 
+     */
+    bool exists(const T&) const;
+
+    /**
+     * Prints the number of elements, the height of the BTreeSet and the
+     * number of nodes.
+     * \notes These values are meant to show how full the nodes are.
+     */
+    void showStatistics(std::ostream& out) const;
+
+    /**
+     * Prints out the items of the BTreeSet, leaf by leaf.
+     */
+    std::ostream& print(std::ostream&) const;
+
+private:
+    Node* root_;       ///< Top-level node of this tree.
+    Leaf* firstLeaf_;  ///< Leftmost leaf; the leaves form a linked list.
+    size_t size_;      ///< Number of items in the tree.
+    int height_;       ///< Number of levels above the leaves.
+    size_t nodes_;     ///< Number of leaves and inner nodes.
+
+    /**
+     * \struct Node
+     * \brief Keys shared by leaves and inner nodes of the BTreeSet.
+     */
+    struct Node {
+        explicit Node(bool leaf);
+
+        bool leaf_;      ///< True if this node is a Leaf
+        size_t count_;   ///< Number of keys in use
+        T keys_[B];      ///< Sorted keys; only the first count_ are valid
+    };
+
+    /**
+     * \struct Leaf
+     * \brief Bottom-level node holding the items themselves.
+     */
+    struct Leaf : Node {
+        Leaf();
+
+        Leaf* next_;     ///< Next leaf to the right
+    };
+
+    /**
+     * \struct Inner
+     * \brief Routing node; child i holds items in [keys_[i-1], keys_[i]).
+     */
+    struct Inner : Node {
+        Inner();
+
+        Node* children_[B + 1]; ///< Subtrees; count_ + 1 are valid
+    };
+
+    /**
+     * \brief Returns the number of the first count keys less than item.
+     */
+    static size_t countLess(const T* keys, size_t count, const T& item);
+
+    /**
+     * \brief Returns the number of the first count keys not greater than
+     *        item.
+     */
+    static size_t countNotGreater(const T* keys, size_t count, const T& item);
+
+    /**
+     * \brief Adds item to the subtree whose root is here.
+     *
+     * \returns false if item was already present.
+     * \post If here had to split, splitNode is its new right sibling and
+     *       splitKey the smallest key that belongs there; otherwise
+     *       splitNode is nullptr.
+     */
+    bool insertNode(Node* here, const T& item, T& splitKey, Node*& splitNode);
+
+    /**
+     * \brief Adds item to a leaf, splitting it if it is full.
+     *
+     * \note Helper function for insertNode, with the same contract.
+     */
+    bool insertLeaf(Leaf* here, const T& item, T& splitKey, Node*& splitNode);
+
+    /**
+     * \brief Adds key and the child to its right at position i of here,
+     *        splitting here if it is full.
+     *
+     * \note Helper function for insertNode.
+     */
+    void insertChild(Inner* here, size_t i, const T& key, Node* child,
+                     T& splitKey, Node*& splitNode);
+
+    /**
+     * \brief Deletes here and its subtrees.
+     *
+     * \note Helper function for the destructor.
+     */
+    void deleteNode(Node* here);
+};
+
+#include "btreeset-private.hpp"
+
+#endif
@@ -0,0 +1,214 @@
+/**
+ * \file concurrenttreeset-private.hpp
+ *
+ * \author Rachel Lee
+ *
+ * \brief Implements ConcurrentTreeSet<T>
+ *
+ * \remark There is no include-guard for this file, because it is
+ *         only #included by concurrenttreeset.hpp, inside
+ *         concurrenttreeset.hpp's own include guard.
+ */
+
+#include <algorithm>
+
+template <class T>
+ConcurrentTreeSet<T>::ConcurrentTreeSet() :
+    root_{nullptr}
+{
+    std::random_device rd;
+    gen_ = std::mt19937{rd()};
+}
+
+template <class T>
+ConcurrentTreeSet<T>::~ConcurrentTreeSet()
+{
+    deleteNode(root_.load());
+}
+
+template <class T>
+void ConcurrentTreeSet<T>::deleteNode(const Node* here)
+{
+    if (here != nullptr) {
+        deleteNode(here->left_);
+        deleteNode(here->right_);
+        delete here;
+    }
+}
+
+template <class T>
+size_t ConcurrentTreeSet<T>::size() const
+{
+    EpochDomain::Guard guard{epochs_};
+    return sizeNode(root_.load(std::memory_order_acquire));
+}
+
+template <class T>
+int ConcurrentTreeSet<T>::height() const
+{
+    EpochDomain::Guard guard{epochs_};
+    return heightNode(root_.load(std::memory_order_acquire));
+}
+
+template <class T>
+void ConcurrentTreeSet<T>::insert(const T& item)
+{
+    std::lock_guard<std::mutex> lock{writer_};
+    // Only writers change the tree, so holding writer_ keeps this answer true
+    if (exists(item))
+        return;
+    EpochDomain::Guard guard{epochs_};
+
+    std::vector<const Node*> replaced;
+    const Node* root = insertNode(item, root_.load(), replaced);
+    root_.store(root, std::memory_order_release);
+
+    // Readers that started before the store may still be walking these
+    for (const Node* old : replaced)
+        epochs_.retire(const_cast<Node*>(old));
+}
+
+template <class T>
+const typename ConcurrentTreeSet<T>::Node*
+ConcurrentTreeSet<T>::insertNode(const T& item, const Node* here,
+                                 std::vector<const Node*>& replaced)
+{
+    if (gen_() % (sizeNode(here)+1) == 0) {
+        const Node* less;
+        const Node* greater;
+        split(item, here, less, greater, replaced);
+        return new Node(item, less, greater,
+                        sizeNode(less) + sizeNode(greater) + 1);
+    }
+
+    replaced.push_back(here);
+    if (here->value_ < item)
+        return new Node(here->value_, here->left_,
+                        insertNode(item, here->right_, replaced),
+                        here->size_ + 1);
+    else
+        return new Node(here->value_,
+                        insertNode(item, here->left_, replaced),
+                        here->right_, here->size_ + 1);
+}
+
+template <class T>
+void ConcurrentTreeSet<T>::split(const T& item, const Node* here,
+                                 const Node*& less, const Node*& greater,
+                                 std::vector<const Node*>& replaced)
+{
+    if (here == nullptr) {
+        less = greater = nullptr;
+        return;
+    }
+
+    // Same result as the rotations TreeSet::insertNodeAtRoot performs
+    replaced.push_back(here);
+    if (here->value_ < item) {
+        const Node* middle;
+        split(item, here->right_, middle, greater, replaced);
+        less = new Node(here->value_, here->left_, middle,
+                        sizeNode(here->left_) + sizeNode(middle) + 1);
+    } else {
+        const Node* middle;
+        split(item, here->left_, less, middle, replaced);
+        greater = new Node(here->value_, middle, here->right_,
+                           sizeNode(middle) + sizeNode(here->right_) + 1);
+    }
+}
+
+template <class T>
+bool ConcurrentTreeSet<T>::exists(const T& item) const
+{
+    EpochDomain::Guard guard{epochs_};
+
+    const Node* here = root_.load(std::memory_order_acquire);
+    while (here != nullptr) {
+        if (item < here->value_)
+            here = here->left_;
+        else if (here->value_ < item)
+            here = here->right_;
+        else
+            return true;
+    }
+    return false;
+}
+
+template <class T>
+template <class Visitor>
+void ConcurrentTreeSet<T>::forEachInRange(const T& lo, const T& hi,
+                                          Visitor&& visit) const
+{
+    EpochDomain::Guard guard{epochs_};
+    nodeRange(lo, hi, root_.load(std::memory_order_acquire), visit);
+}
+
+template <class T>
+template <class Visitor>
+void ConcurrentTreeSet<T>::nodeRange(const T& lo, const T& hi,
+                                     const Node* here, Visitor& visit) const
+{
+    if (here == nullptr)
+        return;
+
+    bool aboveLo = !(here->value_ < lo);
+    bool belowHi = here->value_ < hi;
+    if (aboveLo)
+        nodeRange(lo, hi, here->left_, visit);
+    if (aboveLo && belowHi)
+        visit(here->value_);
+    if (belowHi)
+        nodeRange(lo, hi, here->right_, visit);
+}
+
+template <class T>
+void ConcurrentTreeSet<T>::showStatistics(std::ostream& out) const
+{
+    out << "height " << height() << ", size " << size() << std::endl;
+}
+
+template <class T>
+std::ostream& ConcurrentTreeSet<T>::print(std::ostream& out) const
+{
+    EpochDomain::Guard guard{epochs_};
+    return nodePrint(out, root_.load(std::memory_order_acquire));
+}
+
+template <class T>
+std::ostream& ConcurrentTreeSet<T>::nodePrint(std::ostream& out,
+                                              const Node* here) const
+{
+    if (here == nullptr)
+        out << "-";
+    else {
+        out << "(";
+        nodePrint(out, here->left_); 
+        out << ", " << here->value_ << ", ";
+        nodePrint(out, here->right_) << ")";
+    }
+    return out;
+}
+
+template <class T>
+int ConcurrentTreeSet<T>::heightNode(const Node* here) const
+{
+    if (here == nullptr)
+        return -1;
+    return 1 + std::max(heightNode(here->left_), heightNode(here->right_));
+}
+
+template <class T>
+size_t ConcurrentTreeSet<T>::sizeNode(const Node* here)
+{
+    if (here == nullptr)
+        return 0;
+    return here->size_;
+}
+
+template <class T>
+ConcurrentTreeSet<T>::Node::Node(const T& value, const Node* left,
+                                 const Node* right, size_t size) :
+    value_{value}, left_{left}, right_{right}, size_{size}
+{
+    // Nothing to do
+}
@@ -0,0 +1,175 @@
+/**
+ * \file concurrenttreeset.hpp
+ *
+ * \author Rachel Lee
+ *
+ * \brief Provides ConcurrentTreeSet<T>, a randomized BST that readers can
+ *        search without locking while a writer inserts
+ */
+
+#ifndef CONCURRENTTREESET_HPP_INCLUDED
+#define CONCURRENTTREESET_HPP_INCLUDED 1
+
+#include <atomic>
+#include <cstddef>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <vector>
+
+#include "../../Concurrency/epochdomain.hpp"
+
+/**
+ * \class ConcurrentTreeSet
+ *
+ * \brief A persistent randomized binary search tree with lock-free reads.
+ *
+ * \details Nodes never change once published. An insert copies the path it
+ *          changes, and insert-at-root becomes a split of that path, so the
+ *          tree has the same shape distribution as TreeSet. The insert then
+ *          publishes the new version with one atomic store to the root.
+ *          Readers see either the old or the new version, never a mix.
+ *          Replaced nodes are reclaimed through an EpochDomain. Writers are
+ *          serialized by a mutex.
+ */
+template <class T>
+class ConcurrentTreeSet {
+private:
+    struct Node;
+
+public:
+    ConcurrentTreeSet(); ///< Default constructor
+
+    ~ConcurrentTreeSet(); ///< Destructor
+    
+    ConcurrentTreeSet(const ConcurrentTreeSet& copy) = delete;
+    
+    ConcurrentTreeSet& operator=(const ConcurrentTreeSet& rhs) = delete;
+
+    size_t size() const; ///< Number of items in the ConcurrentTreeSet.
+
+    int height() const; ///< Returns height of the tree.
+
+    /**
+     * \brief Adds item to the ConcurrentTreeSet. 
+     *
+     * \note Adding an item that is already in the tree does nothing.
+     */
+    void insert(const T&);
+ 
+    /**
+     * \brief Returns true if item is present in the ConcurrentTreeSet and
+     *        false otherwise. Never blocks.
+     */
+    bool exists(const T&) const;
+
+    /**
+     * \brief Calls visit(item) on every item in [lo, hi), in order.
+     *
+     * \details The whole scan sees one version of the tree, even if a writer
+     *          inserts while it runs. Never blocks.
+     */
+    template <class Visitor>
+    void forEachInRange(const T& lo, const T& hi, Visitor&& visit) const;
+
+    /**
+     * Prints the number of elements, the height of the ConcurrentTreeSet.
+     * \notes These values are meant to show whether the tree is
+     *        relatively well-balanced.
+     */
+    void showStatistics(std::ostream& out) const;
+
+    /**
+     * Prints out a representation of the ConcurrentTreeSet.
+     */
+    std::ostream& print(std::ostream&) const;
+
+private:
+    std::atomic<const Node*> root_; ///< Current version of the tree.
+
+    /**
+     * \class Node
+     * \brief Immutable node for ConcurrentTreeSet.
+     */
+    struct Node : EpochDomain::Retirable {
+        Node() = delete;
+
+        /**
+         * Parameterized Constructor
+         */
+        Node(const T& value, const Node* left, const Node* right, size_t size);
+
+        const T value_; ///< Value stored in this node
+
+        const Node* const left_; ///< Left subtree of this node
+        const Node* const right_; ///< Right subtree of this node
+
+        const size_t size_; ///< Number of items in this node and its subtrees
+    };
+
+    /**
+     * Helper function for getting the height of a tree.
+     */
+    int heightNode(const Node* here) const;
+
+    /**
+     * Helper function for getting the size of a node.
+     */
+    static size_t sizeNode(const Node* here);
+
+    /**
+     * \brief Returns a copy of here's subtree with item added.
+     *
+     * \note Helper function for insert. Every node of here's subtree that
+     *       the copy no longer uses is appended to replaced.
+     */
+    const Node* insertNode(const T& item, const Node* here,
+                           std::vector<const Node*>& replaced);
+
+    /**
+     * \brief Splits here's subtree into copies holding the items less than
+     *        item (less) and greater than item (greater).
+     *
+     * \note Helper function for insertNode, which puts item at the root of
+     *       the two halves. Split nodes are appended to replaced.
+     */
+    void split(const T& item, const Node* here, const Node*& less,
+               const Node*& greater, std::vector<const Node*>& replaced);
+
+    /**
+     * \brief Calls visit on the items of here's subtree in [lo, hi).
+     *
+     * \note Helper function for forEachInRange.
+     */
+    template <class Visitor>
+    void nodeRange(const T& lo, const T& hi, const Node* here,
+                   Visitor& visit) const;
+
+    /**
+     * \brief Deletes here and its subtrees.
+     *
+     * \note Helper function for the destructor.
+     */
+    void deleteNode(const Node* here);
+
+    /**
+     * \brief Prints here and its subtrees.
+     *
+     * \note Helper function for print.
+     */
+    std::ostream& nodePrint(std::ostream&, const Node* here) const;
+
+    std::mutex writer_; ///< Held by the thread that is inserting.
+
+    /// Keeps replaced nodes alive while readers may still hold them.
+    mutable EpochDomain epochs_;
+
+    /**
+     * Number generator for getting values from real distribution.
+     */
+    std::mt19937 gen_;
+};
+
+#include "concurrenttreeset-private.hpp"
+
+#endif
@@ -12,182 +12,396 @@
 
 #include <iostream>
 #include <algorithm>
+#include <stdexcept>
+
+#include "../../Instrumentation/probes.hpp"
 
 using namespace std;
 
-template <class T>
-TreeSet<T>::TreeSet() :
-    root_{nullptr}
+template <class T, class Index, class Allocator, size_t N>
+TreeSet<T, Index, Allocator, N>::TreeSet() :
+    TreeSet{Allocator()}
 {
-    std::random_device rd;
-    gen_ = mt19937{rd()};
 }
 
-template <class T>
-TreeSet<T>::~TreeSet()
+template <class T, class Index, class Allocator, size_t N>
+TreeSet<T, Index, Allocator, N>::TreeSet(const Allocator& alloc) :
+    nodes_{NodeAllocator(alloc)}, root_{NIL}, gen_{Random::nextSeed()}
 {
-    deleteNode(root_);
 }
 
-template <class T>
-void TreeSet<T>::deleteNode(Node*& here)
+template <class T, class Index, class Allocator, size_t N>
+template <class InputIterator>
+TreeSet<T, Index, Allocator, N>::TreeSet(InputIterator first, InputIterator last,
+                                      const Allocator& alloc) :
+    TreeSet{alloc}
 {
-    if (here != nullptr) {
-        deleteNode(here->left_);
-        deleteNode(here->right_);
-        delete here;
+    // Scratch space comes from the same place as the nodes
+    std::vector<T, Allocator> sorted(first, last, alloc);
+
+    // Bulk loads usually arrive sorted, in which case we skip the sort
+    if (!std::is_sorted(sorted.begin(), sorted.end()))
+        std::sort(sorted.begin(), sorted.end());
+
+    // TreeSet only relies on operator<, so equality is !(a < b) && !(b < a)
+    auto equivalent = [](const T& a, const T& b) {
+        return !(a < b) && !(b < a);
+    };
+    sorted.erase(std::unique(sorted.begin(), sorted.end(), equivalent),
+                 sorted.end());
+
+    if (sorted.size() <= N) {
+        for (const T& item : sorted)
+            small_.push_back(item);
+        return;
     }
+    // Checked up front, so the subtree sizes below can't be truncated
+    checkRoomFor(sorted.size());
+    nodes_.reserve(sorted.size());
+    root_ = buildNode(sorted, 0, sorted.size());
+}
+
+template <class T, class Index, class Allocator, size_t N>
+Index TreeSet<T, Index, Allocator, N>::buildNode(
+    const std::vector<T, Allocator>& sorted, size_t lo, size_t hi)
+{
+    if (lo == hi)
+        return NIL;
+
+    size_t mid = lo + (hi - lo) / 2;
+    Index left = buildNode(sorted, lo, mid);
+    Index right = buildNode(sorted, mid + 1, hi);
+    return newNode(sorted[mid], left, right, Index(hi - lo));
+}
+
+template <class T, class Index, class Allocator, size_t N>
+Index TreeSet<T, Index, Allocator, N>::newNode(const T& value, Index left, Index right,
+                                 Index size)
+{
+    checkRoomFor(nodes_.size() + 1);
+    nodes_.emplace_back(value, left, right, size);
+    return Index(nodes_.size() - 1);
+}
+
+template <class T, class Index, class Allocator, size_t N>
+void TreeSet<T, Index, Allocator, N>::checkRoomFor(size_t nodes) const
+{
+    // NIL is reserved, so the arena can hold one node fewer than Index counts
+    if (nodes >= size_t(NIL))
+        throw std::length_error("TreeSet: too many items for its Index type");
+}
+
+template <class T, class Index, class Allocator, size_t N>
+Allocator TreeSet<T, Index, Allocator, N>::get_allocator() const
+{
+    return Allocator(nodes_.get_allocator());
 }
 
-template <class T>
-size_t TreeSet<T>::size() const
+template <class T, class Index, class Allocator, size_t N>
+size_t TreeSet<T, Index, Allocator, N>::size() const
 {
-    return sizeNode(root_);
+    return root_ == NIL ? small_.size() : sizeNode(root_);
 }
 
-template <class T>
-int TreeSet<T>::height() const
+template <class T, class Index, class Allocator, size_t N>
+int TreeSet<T, Index, Allocator, N>::height() const
 {
+    // Inline items count as a single level
+    if (root_ == NIL)
+        return small_.size() == 0 ? -1 : 0;
     return heightNode(root_);
 }
 
-template <class T>
-void TreeSet<T>::insert(const T& item)
+template <class T, class Index, class Allocator, size_t N>
+void TreeSet<T, Index, Allocator, N>::insert(const T& item)
 {
+    DATASTRUCTURES_PROBE("TreeSet::insert");
+    if (root_ == NIL) {
+        if (small_.containsEquivalent(item))
+            return;
+        if (!small_.full()) {
+            small_.push_back(item);
+            return;
+        }
+        moveToTree();
+    } else if (nodeExists(item, root_)) {
+        return;
+    }
+
+    // insertNode bumps sizes on its way down, so fail before it starts
+    checkRoomFor(nodes_.size() + 1);
+
+    // insertNode holds references into the arena, so grow it up front
+    if (nodes_.size() == nodes_.capacity())
+        nodes_.reserve(std::max<size_t>(16, 2 * nodes_.capacity()));
+
     insertNode(item, root_);
 }
 
-template <class T>
-void TreeSet<T>::insertNode(const T& item, Node*& here)
+template <class T, class Index, class Allocator, size_t N>
+void TreeSet<T, Index, Allocator, N>::moveToTree()
+{
+    std::vector<T, Allocator> sorted(small_.begin(), small_.end(),
+                                     get_allocator());
+    std::sort(sorted.begin(), sorted.end());
+    small_.clear();
+
+    // One more node is about to arrive
+    nodes_.reserve(sorted.size() + 1);
+    root_ = buildNode(sorted, 0, sorted.size());
+}
+
+template <class T, class Index, class Allocator, size_t N>
+void TreeSet<T, Index, Allocator, N>::insertNode(const T& item, Index& here)
 {
     if (gen_() % (sizeNode(here)+1) == 0)
         insertNodeAtRoot(here, item);
-    else if (here->value_ < item) {
-        ++(here->size_);
-        insertNode(item, here->right_);
+    else if (nodes_[here].value_ < item) {
+        ++(nodes_[here].size_);
+        insertNode(item, nodes_[here].right_);
     } else {
-        ++(here->size_);
-        insertNode(item, here->left_);
+        ++(nodes_[here].size_);
+        insertNode(item, nodes_[here].left_);
     }
 }
 
-template <class T> 
-void TreeSet<T>::insertNodeAtRoot(Node*& here, const T& value) 
+template <class T, class Index, class Allocator, size_t N>
+void TreeSet<T, Index, Allocator, N>::insertNodeAtRoot(Index& here, const T& value) 
 {
-    if (here == nullptr) {
-        here = new Node(value, NULL, NULL, 1); 
-    } else if (value < here->value_) {
-        ++(here->size_);
-        insertNodeAtRoot(here->left_, value); 
+    if (here == NIL) {
+        here = newNode(value, NIL, NIL, 1); 
+    } else if (value < nodes_[here].value_) {
+        ++(nodes_[here].size_);
+        insertNodeAtRoot(nodes_[here].left_, value); 
         rightRotate(here); 
     } else {
-        ++(here->size_);
-        insertNodeAtRoot(here->right_, value); 
+        ++(nodes_[here].size_);
+        insertNodeAtRoot(nodes_[here].right_, value); 
         leftRotate(here); 
     }
 }    
 
-template <class T>
-bool TreeSet<T>::exists(const T& item) const
+template <class T, class Index, class Allocator, size_t N>
+bool TreeSet<T, Index, Allocator, N>::exists(const T& item) const
 {
+    DATASTRUCTURES_PROBE("TreeSet::exists");
+    if (root_ == NIL)
+        return small_.containsEquivalent(item);
     return nodeExists(item, root_);
 }
 
-template <class T>
-bool TreeSet<T>::nodeExists(const T& item, const Node* here) const
+template <class T, class Index, class Allocator, size_t N>
+bool TreeSet<T, Index, Allocator, N>::nodeExists(const T& item, Index here) const
 {
-    if (here == nullptr)
+    if (here == NIL)
         return false;
-    else if (item < here->value_)
-        return nodeExists(item, here->left_);
-    else if (here->value_ < item)
-        return nodeExists(item, here->right_);
+    else if (item < nodes_[here].value_)
+        return nodeExists(item, nodes_[here].left_);
+    else if (nodes_[here].value_ < item)
+        return nodeExists(item, nodes_[here].right_);
     else
         return true;
 
 }
 
-template <class T>
-void TreeSet<T>::showStatistics(ostream& out) const
+template <class T, class Index, class Allocator, size_t N>
+TreeSnapshot<T> TreeSet<T, Index, Allocator, N>::compact() const
+{
+    std::vector<T> sorted;
+    sorted.reserve(size());
+    nodeInorder(root_, sorted);
+    if (root_ == NIL) {
+        sorted.assign(small_.begin(), small_.end());
+        std::sort(sorted.begin(), sorted.end());
+    }
+    return TreeSnapshot<T>{sorted};
+}
+
+template <class T, class Index, class Allocator, size_t N>
+void TreeSet<T, Index, Allocator, N>::nodeInorder(Index here, std::vector<T>& out) const
+{
+    if (here != NIL) {
+        nodeInorder(nodes_[here].left_, out);
+        out.push_back(nodes_[here].value_);
+        nodeInorder(nodes_[here].right_, out);
+    }
+}
+
+template <class T, class Index, class Allocator, size_t N>
+void TreeSet<T, Index, Allocator, N>::showStatistics(ostream& out) const
 {
     out << "height " << height() << ", size " << size() << endl;
 }
 
-template <class T>
-ostream& TreeSet<T>::print(ostream& out) const
+template <class T, class Index, class Allocator, size_t N>
+ostream& TreeSet<T, Index, Allocator, N>::print(ostream& out) const
 {
-    return nodePrint(out, root_);
+    if (root_ != NIL || small_.size() == 0)
+        return nodePrint(out, root_);
+
+    // Inline items have no shape to show, just their order
+    std::vector<T> sorted(small_.begin(), small_.end());
+    std::sort(sorted.begin(), sorted.end());
+    out << "[";
+    for (size_t i = 0; i < sorted.size(); ++i)
+        out << (i == 0 ? "" : ", ") << sorted[i];
+    return out << "]";
 }
 
-template <class T>
-ostream& TreeSet<T>::nodePrint(ostream& out, const Node* here) const
+template <class T, class Index, class Allocator, size_t N>
+ostream& TreeSet<T, Index, Allocator, N>::nodePrint(ostream& out, Index here) const
 {
-    if (here == nullptr)
+    if (here == NIL)
         out << "-";
     else {
         out << "(";
-        nodePrint(out, here->left_); 
-        out << ", " << here->value_ << ", ";
-        nodePrint(out, here->right_) << ")";
+        nodePrint(out, nodes_[here].left_); 
+        out << ", " << nodes_[here].value_ << ", ";
+        nodePrint(out, nodes_[here].right_) << ")";
     }
     return out;
 }
 
-template <class T>
-int TreeSet<T>::heightNode(Node* here) const
+template <class T, class Index, class Allocator, size_t N>
+int TreeSet<T, Index, Allocator, N>::heightNode(Index here) const
 {
-    if (here == nullptr)
+    if (here == NIL)
         return -1;
-    return 1 + max(heightNode(here->left_), heightNode(here->right_));
+    return 1 + max(heightNode(nodes_[here].left_),
+                   heightNode(nodes_[here].right_));
 }
 
-template <class T>
-int TreeSet<T>::sizeNode(Node* here) const
+template <class T, class Index, class Allocator, size_t N>
+size_t TreeSet<T, Index, Allocator, N>::sizeNode(Index here) const
 {
-    if (here == nullptr)
+    if (here == NIL)
         return 0;
-    return here->size_;
+    return nodes_[here].size_;
 }
 
-template <class T>
-void TreeSet<T>::rightRotate(Node*& here)
+template <class T, class Index, class Allocator, size_t N>
+void TreeSet<T, Index, Allocator, N>::rightRotate(Index& here)
 {
     fixSizeRight(here);
-    Node* b = here->left_;
-    here->left_ = b->right_;
-    b->right_ = here;
+    Index b = nodes_[here].left_;
+    nodes_[here].left_ = nodes_[b].right_;
+    nodes_[b].right_ = here;
     here = b;
 }
 
-template <class T>
-void TreeSet<T>::leftRotate(Node*& here)
+template <class T, class Index, class Allocator, size_t N>
+void TreeSet<T, Index, Allocator, N>::leftRotate(Index& here)
 {
     fixSizeLeft(here);
-    Node* d = here->right_;
-    here->right_ = d->left_;
-    d->left_ = here;
+    Index d = nodes_[here].right_;
+    nodes_[here].right_ = nodes_[d].left_;
+    nodes_[d].left_ = here;
     here = d;
 }
 
-template <class T>
-void TreeSet<T>::fixSizeRight(Node*& here)
+template <class T, class Index, class Allocator, size_t N>
+void TreeSet<T, Index, Allocator, N>::fixSizeRight(Index here)
 {
-    size_t hereSize = sizeNode(here);
-    here->size_ = sizeNode(here->right_) + sizeNode(here->left_->right_);
-    here->left_->size_ = hereSize;
+    Node& node = nodes_[here];
+    Index hereSize = node.size_;
+    node.size_ = Index(1 + sizeNode(node.right_)
+                         + sizeNode(nodes_[node.left_].right_));
+    nodes_[node.left_].size_ = hereSize;
 }
 
-template <class T>
-void TreeSet<T>::fixSizeLeft(Node*& here)
+template <class T, class Index, class Allocator, size_t N>
+void TreeSet<T, Index, Allocator, N>::fixSizeLeft(Index here)
 {
-    size_t hereSize = sizeNode(here);
-    here->size_ = sizeNode(here->left_) + sizeNode(here->right_->left_);
-    here->right_->size_ = hereSize;
+    Node& node = nodes_[here];
+    Index hereSize = node.size_;
+    node.size_ = Index(1 + sizeNode(node.left_)
+                         + sizeNode(nodes_[node.right_].left_));
+    nodes_[node.right_].size_ = hereSize;
 }
 
-template <class T>
-TreeSet<T>::Node::Node(const T& value, Node* left, Node* right, size_t size) :
+template <class T, class Index, class Allocator, size_t N>
+TreeSet<T, Index, Allocator, N>::Node::Node(const T& value, Index left, Index right,
+                              Index size) :
     value_{value}, left_{left}, right_{right}, size_{size}
 {
     // Nothing to do
-}
\ No newline at end of file
+}
+
+template <class T, class Index, class Allocator, size_t N>
+bool TreeSet<T, Index, Allocator, N>::consistent() const
+{
+    if (root_ == NIL) {
+        for (const T* i = small_.begin(); i != small_.end(); ++i) {
+            for (const T* j = small_.begin(); j != i; ++j) {
+                if (!(*i < *j) && !(*j < *i))
+                    return false;
+            }
+        }
+        return nodes_.empty();
+    }
+
+    if (!nodeConsistent(root_, nullptr, nullptr)
+        || sizeNode(root_) != nodes_.size() || small_.size() != 0)
+        return false;
+
+    // A binary tree of height h holds between h + 1 and 2^(h+1) - 1 items
+    size_t items = size();
+    size_t height = size_t(heightNode(root_));
+    return height < items
+           && (height >= 63 || items < (size_t(1) << (height + 1)));
+}
+
+template <class T, class Index, class Allocator, size_t N>
+bool TreeSet<T, Index, Allocator, N>::nodeConsistent(Index here,
+                                                     const T* lower,
+                                                     const T* upper) const
+{
+    if (here == NIL)
+        return true;
+    if (here >= nodes_.size())
+        return false;
+
+    const Node& node = nodes_[here];
+    if ((lower != nullptr && !(*lower < node.value_))
+        || (upper != nullptr && !(node.value_ < *upper)))
+        return false;
+    // The children's indices are checked before their sizes are read
+    return nodeConsistent(node.left_, lower, &node.value_)
+           && nodeConsistent(node.right_, &node.value_, upper)
+           && sizeNode(here) == 1 + sizeNode(node.left_)
+                                  + sizeNode(node.right_);
+}
+
+// --------------------------------------
+// Implementation of TreeSet::Random
+// --------------------------------------
+
+template <class T, class Index, class Allocator, size_t N>
+TreeSet<T, Index, Allocator, N>::Random::Random(std::uint64_t seed)
+    : state_{seed | 1}
+{
+    // Nothing else to do
+}
+
+template <class T, class Index, class Allocator, size_t N>
+std::uint32_t TreeSet<T, Index, Allocator, N>::Random::operator()()
+{
+    // xorshift64*
+    state_ ^= state_ >> 12;
+    state_ ^= state_ << 25;
+    state_ ^= state_ >> 27;
+    return std::uint32_t((state_ * 0x2545F4914F6CDD1DULL) >> 32);
+}
+
+template <class T, class Index, class Allocator, size_t N>
+std::uint64_t TreeSet<T, Index, Allocator, N>::Random::nextSeed()
+{
+    // Asking random_device once per thread rather than once per set keeps
+    // creating a set cheap; splitmix64 spreads the seeds apart
+    static thread_local std::uint64_t seeds =
+        std::uint64_t(std::random_device{}()) << 32 | std::random_device{}();
+    std::uint64_t z = (seeds += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
@@ -10,10 +10,36 @@
 #define TREESET_HPP_INCLUDED 1
 
 #include <cstddef>
+#include <cstdint>
 #include <forward_list>
+#include <memory>
 #include <random>
+#include <vector>
 
-template <class T>
+#include "treesnapshot.hpp"
+#include "../../Memory/smallbuffer.hpp"
+
+/**
+ * \class TreeSet
+ *
+ * \brief A randomized binary search tree.
+ *
+ * \details Nodes live in a single arena and refer to each other by Index
+ *          rather than by pointer, so a TreeSet<int> costs 16 bytes per key
+ *          and is destroyed by releasing one block. The default 32-bit
+ *          Index holds up to 2^32 - 1 items; use a wider Index for larger
+ *          sets.
+ *
+ *          The arena comes from Allocator, so with a
+ *          std::pmr::polymorphic_allocator a TreeSet can live in a
+ *          request's arena.
+ *
+ *          The first N items are kept inline and found by a linear scan;
+ *          the tree is only built, and the items moved into it, when item
+ *          N + 1 arrives.
+ */
+template <class T, class Index = std::uint32_t,
+          class Allocator = std::allocator<T>, size_t N = 0>
 class TreeSet {
 private:
     struct Node;
@@ -21,7 +47,21 @@ private:
 public:
     TreeSet(); ///< Default constructor
 
-    ~TreeSet(); ///< Destructor
+    explicit TreeSet(const Allocator& alloc); ///< Uses alloc for the arena
+
+    /**
+     * \brief Builds a balanced TreeSet holding the items in [first, last).
+     *
+     * \details Runs in O(n) when the range is already sorted and in
+     *          O(n log n) otherwise. Duplicate items are only kept once.
+     * \throws std::length_error if there are more items than Index can
+     *         number.
+     */
+    template <class InputIterator>
+    TreeSet(InputIterator first, InputIterator last,
+            const Allocator& alloc = Allocator());
+
+    ~TreeSet() = default; ///< Destructor
     
     TreeSet(const TreeSet& copy) = delete;
     
@@ -29,13 +69,16 @@ public:
 
     size_t size() const; ///< Number of items in the TreeSet.
 
-    int height() const; ///< Returns height of the tree.
+    Allocator get_allocator() const; ///< Allocator the arena comes from.
+
+    int height() const; ///< Returns height of the tree; 0 while inline.
 
     /**
      * \brief Adds item to the TreeSet. 
      *
-     * \note The function's behavior is undefined if the item has already been
-     *       added to the tree.
+     * \note Adding an item that is already in the tree does nothing.
+     * \throws std::length_error if the tree already holds as many items as
+     *         Index can number.
      */
     void insert(const T&);
  
@@ -45,6 +88,14 @@ public:
      */
     bool exists(const T&) const;
 
+    /**
+     * \brief Returns a read-only copy of the TreeSet laid out for fast
+     *        lookups.
+     *
+     * \details Later inserts into the TreeSet do not affect the snapshot.
+     */
+    TreeSnapshot<T> compact() const;
+
     /**
      * Prints the number of elements, the height of the TreeSet.
      * \notes These values are meant to show whether the tree is
@@ -57,8 +108,30 @@ public:
      */
     std::ostream& print(std::ostream&) const;
 
+    /**
+     * \brief Returns true if the tree's bookkeeping agrees with its shape:
+     *        every node's size_ counts its subtree, the items are in order
+     *        with no duplicates, the arena holds no stray nodes, and
+     *        height() lies between log2(size()) and size() - 1.
+     *
+     * \details Walks the whole tree, so it is meant for checks in
+     *          debugging and stress runs rather than normal use.
+     */
+    bool consistent() const;
+
 private:
-    Node* root_; ///< Top-level node of this tree.
+    /// Index used in place of a null pointer.
+    static constexpr Index NIL = Index(-1);
+
+    static_assert(N < size_t(Index(-1)),
+                  "TreeSet's inline items must fit in a tree of Index nodes");
+
+    using NodeAllocator =
+        typename std::allocator_traits<Allocator>::template rebind_alloc<Node>;
+
+    std::vector<Node, NodeAllocator> nodes_; ///< Arena holding every node.
+
+    Index root_; ///< Top-level node of this tree.
 
     /**
      * \class Node
@@ -70,29 +143,47 @@ private:
         /**
          * Parameterized Constructor
          */
-        Node(const T& value, Node* left, Node* right, size_t size);
+        Node(const T& value, Index left, Index right, Index size);
 
         T value_; ///< Value stored in this node
 
-        Node* left_; ///< Left subtree of this node
-        Node* right_; ///< Right subtree of this node
+        Index left_; ///< Left subtree of this node
+        Index right_; ///< Right subtree of this node
 
-        size_t size_; ///< Number of items in this node and its subtrees
+        Index size_; ///< Number of items in this node and its subtrees
     };
 
+    /**
+     * \brief Places a new node in the arena and returns its index.
+     */
+    Index newNode(const T& value, Index left, Index right, Index size);
+
+    /**
+     * \brief Throws std::length_error unless the arena can hold nodes
+     *        nodes without an index reaching NIL.
+     */
+    void checkRoomFor(size_t nodes) const;
+
     /**
      * Helper function for getting the height of a tree.
      */
-    int heightNode(Node* here) const;
+    int heightNode(Index here) const;
 
     /**
      * Helper function for getting the size of a node.
      */
-    int sizeNode(Node* here) const;
+    size_t sizeNode(Index here) const;
+
+    /**
+     * \brief Checks consistent()'s conditions for the subtree at here,
+     *        whose items must lie strictly between *lower and *upper where
+     *        those aren't null.
+     */
+    bool nodeConsistent(Index here, const T* lower, const T* upper) const;
 
-    void rightRotate(Node*& here); ///< Rotates here's subtree to the right.
+    void rightRotate(Index& here); ///< Rotates here's subtree to the right.
 
-    void leftRotate(Node*& here); ///< Rotates here's subtree to the left.
+    void leftRotate(Index& here); ///< Rotates here's subtree to the left.
 
     /**
      * \brief Adds a node at here.
@@ -100,8 +191,11 @@ private:
      * \note Helper function for insert.
      *       The function's behavior is undefined if the item has already been
      *       added to the tree.
+     *
+     * \warning here refers into nodes_, so the arena must already have room
+     *          for the new node before this is called.
      */
-    void insertNode(const T& value, Node*& here);
+    void insertNode(const T& value, Index& here);
 
     /**
      * \brief Adds a node to the root of the (sub)tree.
@@ -109,45 +203,84 @@ private:
      * \note The function's behavior is undefined if the item has already been
      *       added to the tree.
      */
-    void insertNodeAtRoot(Node*& here, const T& value);
+    void insertNodeAtRoot(Index& here, const T& value);
 
     /**
      * Fixes the size of here and its left child.
      */
-    void fixSizeRight(Node*& here);
+    void fixSizeRight(Index here);
 
     /**
      * Fixes the size of here and its right child.
      */
-    void fixSizeLeft(Node*& here);
+    void fixSizeLeft(Index here);
+
+    /**
+     * \brief Builds a balanced tree from the inline items.
+     */
+    void moveToTree();
+
+    /**
+     * \brief Builds a perfectly balanced subtree from sorted[lo, hi), with
+     *        the size of every node filled in.
+     *
+     * \note Helper function for the range constructor.
+     */
+    Index buildNode(const std::vector<T, Allocator>& sorted, size_t lo,
+                    size_t hi);
 
     /**
      * \brief Checks if item exists in the subtree whose root is here.
      *
      * \note Helper function for exists.
      */
-    bool nodeExists(const T& item, const Node* here) const;
+    bool nodeExists(const T& item, Index here) const;
 
     /**
-     * \brief Deletes here and its subtrees.
+     * \brief Appends the items of here's subtree to out, in order.
      *
-     * \note Helper function for the destructor.
+     * \note Helper function for compact.
      */
-    void deleteNode(Node*& here);
+    void nodeInorder(Index here, std::vector<T>& out) const;
 
     /**
      * \brief Prints here and its subtrees.
      *
      * \note Helper function for print.
      */
-    std::ostream& nodePrint(std::ostream&, const Node* here) const;
+    std::ostream& nodePrint(std::ostream&, Index here) const;
 
     /**
-     * Number generator for getting values from real distribution.
+     * \class Random
+     * \brief A small, fast generator for the insert coin flips.
+     *
+     * \details 8 bytes of state, where std::mt19937 has 5 KB; for a set of
+     *          a few items that would dwarf the items themselves.
      */
-    std::mt19937 gen_;
+    class Random {
+    public:
+        explicit Random(std::uint64_t seed);
+
+        std::uint32_t operator()(); ///< The next number
+
+        static std::uint64_t nextSeed(); ///< A fresh seed for a new set
+
+    private:
+        std::uint64_t state_;
+    };
+
+    /**
+     * Number generator for choosing where new nodes go.
+     */
+    Random gen_;
+
+    SmallBuffer<T, N> small_; ///< The items, while there are at most N
 };
 
+/// A TreeSet that keeps up to N items inline.
+template <class T, size_t N, class Allocator = std::allocator<T>>
+using SmallTreeSet = TreeSet<T, std::uint32_t, Allocator, N>;
+
 #include "treeset-private.hpp"
 
 #endif
@@ -0,0 +1,81 @@
+/**
+ * \file treesnapshot-private.hpp
+ *
+ * \author Rachel Lee
+ *
+ * \brief Implements TreeSnapshot<T>
+ *
+ * \remark There is no include-guard for this file, because it is
+ *         only #included by treesnapshot.hpp, inside treesnapshot.hpp's
+ *         own include guard.
+ */
+
+template <class T>
+TreeSnapshot<T>::TreeSnapshot(const std::vector<T>& sorted)
+{
+    if (sorted.empty())
+        return;
+
+    // Placeholder copies, overwritten in Eytzinger order by fill(); slot 0
+    // is padding and keeps its copy
+    items_.assign(sorted.size() + 1, sorted.front());
+
+    size_t next = 0;
+    fill(sorted, next, 1);
+}
+
+template <class T>
+void TreeSnapshot<T>::fill(const std::vector<T>& sorted, size_t& next,
+                           size_t k)
+{
+    if (k <= size()) {
+        fill(sorted, next, 2 * k);
+        items_[k] = sorted[next++];
+        fill(sorted, next, 2 * k + 1);
+    }
+}
+
+template <class T>
+size_t TreeSnapshot<T>::size() const
+{
+    return items_.empty() ? 0 : items_.size() - 1;
+}
+
+template <class T>
+bool TreeSnapshot<T>::exists(const T& item) const
+{
+    // Slots per cache line. items_ starts on a line, so when sizeof(T)
+    // divides LINE, slot k * PER_LINE starts one and prefetching it pulls
+    // in all of k's descendants log2(PER_LINE) levels down (four for
+    // 4-byte T) in one request.
+    constexpr size_t PER_LINE = sizeof(T) < LINE ? LINE / sizeof(T) : 1;
+
+    size_t n = size();
+    if (n == 0)
+        return false;
+
+    const T* slots = items_.data();
+    size_t k = 1;
+
+    while (k <= n) {
+#if defined(__GNUC__)
+        // Near the leaves the descendants are past the end; prefetch slot
+        // 0 instead rather than form a pointer outside items_
+        size_t ahead = k * PER_LINE;
+        __builtin_prefetch(slots + (ahead <= n ? ahead : 0));
+#endif
+        k = 2 * k + size_t(slots[k] < item);
+    }
+
+    // Every right turn appended a 1 bit; undo the trailing right turns and
+    // the final left turn to recover the last slot where item <= slots[k].
+#if defined(__GNUC__)
+    k >>= __builtin_ffsll(static_cast<long long>(~k));
+#else
+    while (k & 1)
+        k >>= 1;
+    k >>= 1;
+#endif
+
+    return k != 0 && !(item < slots[k]);
+}
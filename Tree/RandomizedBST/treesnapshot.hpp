@@ -0,0 +1,107 @@
+/**
+ * \file treesnapshot.hpp
+ *
+ * \author Rachel Lee
+ *
+ * \brief Provides TreeSnapshot<T>, a read-only copy of a TreeSet laid out
+ *        for fast lookups
+ */
+
+#ifndef TREESNAPSHOT_HPP_INCLUDED
+#define TREESNAPSHOT_HPP_INCLUDED 1
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+/**
+ * \class TreeSnapshot
+ *
+ * \brief An immutable ordered set stored in Eytzinger (BFS) order.
+ *
+ * \details The implicit tree puts the children of slot k at 2k and 2k + 1,
+ *          so the top levels share a handful of cache lines and the search
+ *          can prefetch the descendants several levels ahead. Obtain one
+ *          with TreeSet::compact().
+ */
+template <class T>
+class TreeSnapshot {
+public:
+    /**
+     * \brief Builds a snapshot of the items in sorted.
+     *
+     * \note The behavior is undefined unless sorted is strictly increasing.
+     */
+    explicit TreeSnapshot(const std::vector<T>& sorted);
+
+    size_t size() const; ///< Number of items in the snapshot.
+
+    /**
+     * \brief Returns true if item is present in the snapshot and
+     *        false otherwise. 
+     *
+     * \details The descent does not branch on comparisons.
+     */
+    bool exists(const T& item) const;
+
+private:
+    /**
+     * \brief Fills slot k and its descendants with in-order items from
+     *        sorted, starting at next.
+     *
+     * \note Helper function for the constructor.
+     */
+    void fill(const std::vector<T>& sorted, size_t& next, size_t k);
+
+    /// Bytes in a cache line, which the items are aligned to
+    static constexpr size_t LINE = 64;
+
+    /**
+     * \brief Allocates the items on a cache-line boundary, so the lines
+     *        exists() prefetches each hold whole groups of descendants.
+     */
+    template <class U>
+    struct LineAllocator {
+        using value_type = U;
+
+        LineAllocator() = default;
+
+        template <class V>
+        LineAllocator(const LineAllocator<V>&)
+        {
+        }
+
+        U* allocate(size_t n)
+        {
+            return static_cast<U*>(
+                ::operator new(n * sizeof(U), std::align_val_t{LINE}));
+        }
+
+        void deallocate(U* p, size_t)
+        {
+            ::operator delete(p, std::align_val_t{LINE});
+        }
+
+        template <class V>
+        bool operator==(const LineAllocator<V>&) const
+        {
+            return true;
+        }
+
+        template <class V>
+        bool operator!=(const LineAllocator<V>&) const
+        {
+            return false;
+        }
+    };
+
+    /**
+     * Items in Eytzinger order from items_[1]; items_[0] is padding, so
+     * slot k is items_[k]. Empty when the snapshot is.
+     */
+    std::vector<T, LineAllocator<T>> items_;
+};
+
+#include "treesnapshot-private.hpp"
+
+#endif